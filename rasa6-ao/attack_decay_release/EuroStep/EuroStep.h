@@ -3,7 +3,7 @@ Class Name: EuroStep
 
 Purpose: Manage events that get called often by synthesis programs.
 
-Dependencies: Hardware specific pin configuration. See 'hardware/' for examples.
+Dependencies: A board type, which describes the hardware pins. See 'hardware/' for examples.
 
 Use: Create a sub-class for each new program, then over-ride any of the virtual functions:
 -- on_start_do(): routines called once when program starts
@@ -12,6 +12,10 @@ Use: Create a sub-class for each new program, then over-ride any of the virtual
 -- on_clock_2_rise_do(): routines called whenever the second clock rises
 -- on_clock_2_fall_do(): routines called whenever the second clock falls
 -- on_step_do(): routines called every step in the main program loop
+-- on_audio_do(): routines called at the audio rate (e.g., the next sample of an envelope)
+-- on_control_do(): routines called every few audio ticks (e.g., mapping pots to settings)
+-- -- note: on_control_do() always runs just before the audio tick it falls on, so each
+-- --       tick sees the newest settings, and both run before on_step_do()
 
 Incoming Values: Any jacks, pots, or switches get read automatically during each step.
 The following getters can be used by the virtual functions:
@@ -25,14 +29,32 @@ The following getters can be used by the virtual functions:
 Outgoing Values: Any outputs get written automatically during each step.
 The following setters and can be used by the virtual functions:
 -- output_value_to_dac(index, value): writes to DAC output channel as mV (range 0-4 V)
--- output_value_to_digital(index, value): writes to digital output channel via digitalWrite()
+-- output_value_to_digital(index, value): writes to digital output channel (only when it changes)
 
 Setup Instructions: The following settings are available during setup:
 -- enable_clock_as_jack(index): use input jack as a clock signal (i.e., based on 500 mV threshold)
 -- enable_clock_2_as_jack(index): use input jack as a clock signal (i.e., based on 500 mV threshold)
+-- set_immediate_digital_output(index): write that digital output as soon as it is set,
+-- -- rather than with the others at the end of the step (e.g., for gates that must be on time)
+-- set_audio_rate(hz): how often on_audio_do() runs (default: 0, which is once per step)
+-- -- note: ticks are timed in micros and run during step(), catching up to 4 missed ticks;
+-- --       the outputs are written after each tick, so the DACs change at the audio rate
+-- --       as long as step() runs at least that often (a caught-up tick is written late)
+-- set_control_divider(value): run on_control_do() once every 'value' audio ticks (default: 1)
 -- set_debug(value): sets whether to delay after each step and print to console
 -- -- note: true by default
 
+Board Types: Each header in 'hardware/' makes a board type (e.g., Rasa6AoBoard) and names it
+'Hardware'. EuroStep is EuroStepBoard<Hardware>, so the pins and counts are known when compiling:
+any peripheral the board does not have (e.g., a second DAC, or switches) compiles to nothing.
+-- note: to build for another board, include its header from 'hardware/' before EuroStep.h
+
+Static Hooks: EuroStep calls the hooks through the vtable (so any sub-class works as before).
+For a faster step, derive from EuroStepT<your_class> instead, with the same public hooks:
+-- e.g., class make_new_module : public EuroStepT<make_new_module> { ... };
+-- note: hooks are then called directly, so any hook the module does not define is an
+-- -- empty inline call that compiles to nothing, and there is no vtable in SRAM
+
 The following functions are required to run the program:
 -- start(): put in setup to initialise class
 -- step(): put in main to run the program
@@ -66,46 +88,43 @@ void loop() {
 #include "backend/power_funcs.h"
 #include "backend/transfer_funcs.h"
 #include "backend/bit_funcs.h"
+#include "backend/fixed_funcs.h"
+#include "backend/exp_funcs.h"
 #include "backend/map_funcs.h"
+#include "backend/flash_tables.h"
 #include "backend/read_funcs.h"
 #include "backend/Timer.h"
 #include "backend/Input.h"
 #include "backend/Mcp4822.h"
+#include "backend/Adpcm.h"
+#include "backend/Random.h"
 
-class EuroStep {
+#define EUROSTEP_MAX_AUDIO_TICKS 4  // audio ticks one step may catch up on
+
+template<class Derived, class Board = Hardware>
+class EuroStepT {
 
 public:
 
   bool debug = false;
 
   // incoming values
-  int jack_values[NUMBER_OF_JACKS];  // the input as averaged over 8 readings
-  int pot_values[NUMBER_OF_POTS];
-  bool switch_values[NUMBER_OF_SWITCHES];
+  int jack_values[Board::number_of_jacks];  // the input as averaged over 8 readings
+  int pot_values[Board::number_of_pots];
+  bool switch_values[Board::number_of_switches];
 
   // input classes to manage pin read
-  Input Jack[NUMBER_OF_JACKS];
-  Input Pot[NUMBER_OF_POTS];
-  Input Switch[NUMBER_OF_SWITCHES];
+  Input Jack[Board::number_of_jacks];
+  Input Pot[Board::number_of_pots];
+  Input Switch[Board::number_of_switches];
 
   // split output between DAC and digital streams
   int output_values_to_dac[4] = { 0 };
-  bool output_values_to_digital[NUMBER_OF_DIGITAL_OUTPUTS];
-
-  // output classes
-  Mcp4822 DAC1;
-  Mcp4822 DAC2;
-
-  ///////////////////////////////////////////////////////////////////////////////
-  /// Hardware variables
-  ///////////////////////////////////////////////////////////////////////////////
+  bool output_values_to_digital[Board::number_of_digital_outputs] = {};
 
-  int pins_jack[NUMBER_OF_JACKS] = PINS_JACK;
-  int pins_pot[NUMBER_OF_POTS] = PINS_POT;
-  int pins_switch[NUMBER_OF_SWITCHES] = PINS_SWITCH;
-  int pins_digital_output[NUMBER_OF_DIGITAL_OUTPUTS] = PINS_DIGITAL_OUTPUT;
-  int pins_dac_a[4] = PINS_DAC_A;
-  int pins_dac_b[4] = PINS_DAC_B;
+  // output classes (empty if the board does not have that DAC)
+  typename Mcp4822IfPresent<Board::has_dac_a>::type DAC1;
+  typename Mcp4822IfPresent<Board::has_dac_b>::type DAC2;
 
   ///////////////////////////////////////////////////////////////////////////////
   /// Getters and setters
@@ -141,9 +160,32 @@ public:
   }
   void output_value_to_digital(int index, int value) {
     output_values_to_digital[index] = value;
+    if (bitRead(immediate_digital_outputs, index)) write_digital_outputs(1U << index);
+  }
+
+  // multi-rate hooks, where the audio rate is timed and the control rate is counted from it
+  unsigned long audio_period_micros = 0;  // 0 runs one audio tick per step
+  int control_divider = 1;
+  int control_countdown = 0;
+  Timer audio_timer;
+  void set_audio_rate(unsigned long hz) {
+    audio_period_micros = (hz == 0) ? 0 : 1000000UL / hz;  // the only division
+    audio_timer.reset_timer();
+  }
+  void set_control_divider(int value) {
+    if (value < 1) value = 1;
+    control_divider = value;
+    if (control_countdown > control_divider) control_countdown = control_divider;
   }
 
   // options
+  void set_immediate_digital_output(int index, bool value = true) {
+    if (value) {
+      immediate_digital_outputs |= 1U << index;
+    } else {
+      immediate_digital_outputs &= ~(1U << index);
+    }
+  }
   void set_debug(bool value = true) {
     debug = value;
   }
@@ -152,12 +194,20 @@ public:
   /// These functions are intended to be written by the derived program
   ///////////////////////////////////////////////////////////////////////////////
 
-  virtual void on_start_do() {}
-  virtual void on_clock_rise_do() {}
-  virtual void on_clock_fall_do() {}
-  virtual void on_clock_2_rise_do() {}
-  virtual void on_clock_2_fall_do() {}
-  virtual void on_step_do() {}
+  // used when the derived program does not write its own
+  void on_start_do() {}
+  void on_clock_rise_do() {}
+  void on_clock_fall_do() {}
+  void on_clock_2_rise_do() {}
+  void on_clock_2_fall_do() {}
+  void on_step_do() {}
+  void on_audio_do() {}
+  void on_control_do() {}
+
+  // the derived program, so its hooks are called without a vtable
+  Derived& derived() {
+    return *static_cast<Derived*>(this);
+  }
 
   ///////////////////////////////////////////////////////////////////////////////
   /// This is run at start up to initialise pins based on hardware
@@ -168,44 +218,52 @@ public:
     if (debug) Serial.begin(9600);
 
     // initialise inputs
-    for (int i = 0; i < NUMBER_OF_JACKS; i++) {
-      pinMode(pins_jack[i], INPUT);
-      Jack[i].setup_as_jack(pins_jack[i], V_DIVIDER_R1, V_DIVIDER_R2);
+    for (int i = 0; i < Board::number_of_jacks; i++) {
+      pinMode(Board::pins_jack[i], INPUT);
+      Jack[i].setup_as_jack(Board::pins_jack[i], Board::v_divider_r1, Board::v_divider_r2);
+      Jack[i].set_mV_per_reading(get_jack_mV_per_reading_Q16(Board::v_divider_r1, Board::v_divider_r2));
       Jack[i].set_debug(debug);
     }
-    for (int i = 0; i < NUMBER_OF_POTS; i++) {
-      pinMode(pins_pot[i], INPUT);
-      Pot[i].setup_as_pot(pins_pot[i]);
-      Pot[i].set_max_input_mV(MAX_POT_VOLTAGE);
-      Pot[i].set_reverse_input(REVERSE_POT);
+    for (int i = 0; i < Board::number_of_pots; i++) {
+      pinMode(Board::pins_pot[i], INPUT);
+      Pot[i].setup_as_pot(Board::pins_pot[i]);
+      Pot[i].set_max_input_mV(Board::max_pot_voltage);
+      Pot[i].set_reverse_input(Board::reverse_pot);
+      Pot[i].set_mV_per_reading(pot_mV_per_reading_Q16);
+      Pot[i].set_percent_curve(FlashTable<PotPercentCurveOf<Board::max_pot_voltage, Board::reverse_pot>, 256>::values);
       Pot[i].set_debug(debug);
     }
-    for (int i = 0; i < NUMBER_OF_SWITCHES; i++) {
-      pinMode(pins_switch[i], INPUT_PULLUP);
-      Switch[i].setup_as_switch(pins_switch[i]);
+    for (int i = 0; i < Board::number_of_switches; i++) {
+      pinMode(Board::pins_switch[i], INPUT_PULLUP);
+      Switch[i].setup_as_switch(Board::pins_switch[i]);
       Switch[i].set_debug(debug);
     }
 
     // initialise digital outputs
-    for (int i = 0; i < NUMBER_OF_DIGITAL_OUTPUTS; i++) {
-      pinMode(pins_digital_output[i], OUTPUT);
+    for (int i = 0; i < Board::number_of_digital_outputs; i++) {
+      int pin = Board::pins_digital_output[i];
+      pinMode(pin, OUTPUT);
+      digitalWrite(pin, output_values_to_digital[i]);  // also turns off PWM on the pin
+      digital_output_registers[i] = portOutputRegister(digitalPinToPort(pin));
+      digital_output_masks[i] = digitalPinToBitMask(pin);
+      if (output_values_to_digital[i]) digital_output_shadow |= 1U << i;
     }
 
     // initial DAC 1
-    if (pins_dac_a[0] != -1) {
-      DAC1.set_pins(pins_dac_a[0], pins_dac_a[1], pins_dac_a[2], pins_dac_a[3]);
+    if (Board::has_dac_a) {
+      DAC1.set_pins(Board::pins_dac_a[0], Board::pins_dac_a[1], Board::pins_dac_a[2], Board::pins_dac_a[3]);
       DAC1.set_debug(debug);
       for (int i = 0; i < 4; i++) {
-        pinMode(pins_dac_a[i], OUTPUT);
+        if (Board::pins_dac_a[i] != -1) pinMode(Board::pins_dac_a[i], OUTPUT);
       }
     }
 
     // initial DAC 2
-    if (pins_dac_b[0] != -1) {
-      DAC2.set_pins(pins_dac_b[0], pins_dac_b[1], pins_dac_b[2], pins_dac_b[3]);
+    if (Board::has_dac_b) {
+      DAC2.set_pins(Board::pins_dac_b[0], Board::pins_dac_b[1], Board::pins_dac_b[2], Board::pins_dac_b[3]);
       DAC2.set_debug(debug);
       for (int i = 0; i < 4; i++) {
-        pinMode(pins_dac_b[i], OUTPUT);
+        if (Board::pins_dac_b[i] != -1) pinMode(Board::pins_dac_b[i], OUTPUT);
       }
     }
   }
@@ -215,19 +273,19 @@ public:
   ///////////////////////////////////////////////////////////////////////////////
 
   void read_jacks() {
-    for (int i = 0; i < NUMBER_OF_JACKS; i++) {
+    for (int i = 0; i < Board::number_of_jacks; i++) {
       jack_values[i] = Jack[i].get_input_as_mV();
     }
   }
 
   void read_pots() {
-    for (int i = 0; i < NUMBER_OF_POTS; i++) {
+    for (int i = 0; i < Board::number_of_pots; i++) {
       pot_values[i] = Pot[i].get_input_as_percent();
     }
   }
 
   void read_switches() {
-    for (int i = 0; i < NUMBER_OF_SWITCHES; i++) {
+    for (int i = 0; i < Board::number_of_switches; i++) {
       switch_values[i] = Switch[i].get_input_as_bool();
     }
   }
@@ -239,10 +297,10 @@ public:
   void run_clock_events() {
     if (clock_as_jack > -1) {  // by default program assumes no clock exists
       if (Jack[clock_as_jack].check_if_input_went_low_to_high()) {
-        on_clock_rise_do();
+        derived().on_clock_rise_do();
       }
       if (Jack[clock_as_jack].check_if_input_went_high_to_low()) {
-        on_clock_fall_do();
+        derived().on_clock_fall_do();
       }
     }
   }
@@ -250,10 +308,10 @@ public:
   void run_clock_2_events() {
     if (clock_2_as_jack > -1) {  // by default program assumes no clock exists
       if (Jack[clock_2_as_jack].check_if_input_went_low_to_high()) {
-        on_clock_2_rise_do();
+        derived().on_clock_2_rise_do();
       }
       if (Jack[clock_2_as_jack].check_if_input_went_high_to_low()) {
-        on_clock_2_fall_do();
+        derived().on_clock_2_fall_do();
       }
     }
   }
@@ -262,23 +320,96 @@ public:
   /// This is a generic way to write digital outputs or use MCP4822 DAC
   ///////////////////////////////////////////////////////////////////////////////
 
-  void write_outputs() {
+  // digital outputs are written straight to their port registers, one bit per output
+  static_assert(Board::number_of_digital_outputs <= 16, "at most 16 digital outputs");
+  volatile uint8_t* digital_output_registers[Board::number_of_digital_outputs];
+  uint8_t digital_output_masks[Board::number_of_digital_outputs];
+  uint16_t digital_output_shadow = 0;      // the value last written to each output
+  uint16_t immediate_digital_outputs = 0;  // outputs written as soon as they are set
+
+  // write the selected outputs that changed, with one read-modify-write for each port
+  void write_digital_outputs(uint16_t selected = 0xFFFF) {
 
-    // write analog output
-    DAC1.send_to_channel_A(output_values_to_dac[0]);
-    DAC1.send_to_channel_B(output_values_to_dac[1]);
-    DAC2.send_to_channel_A(output_values_to_dac[2]);
-    DAC2.send_to_channel_B(output_values_to_dac[3]);
-
-    for (int i = 0; i < NUMBER_OF_DIGITAL_OUTPUTS; i++) {
-      if (debug) {
-        Serial.print("Writing digital output ");
-        Serial.print(i);
-        Serial.print(": ");
-        Serial.print(output_values_to_digital[i]);
-        Serial.println("");
+    // dirty bits, from comparing with the shadow (so direct writes to the array count too)
+    uint16_t dirty = 0;
+    for (int i = 0; i < Board::number_of_digital_outputs; i++) {
+      if (output_values_to_digital[i] != bitRead(digital_output_shadow, i)) dirty |= 1U << i;
+    }
+    dirty &= selected;
+
+    while (dirty) {
+      volatile uint8_t* port = nullptr;
+      uint8_t set = 0;
+      uint8_t clear = 0;
+      for (int i = 0; i < Board::number_of_digital_outputs; i++) {
+        if (!bitRead(dirty, i)) continue;
+        if (port == nullptr) port = digital_output_registers[i];
+        if (digital_output_registers[i] != port) continue;  // another port, so next time around
+        if (output_values_to_digital[i]) {
+          set |= digital_output_masks[i];
+        } else {
+          clear |= digital_output_masks[i];
+        }
+        dirty &= ~(1U << i);
+        digital_output_shadow ^= 1U << i;
+        if (debug) {
+          Serial.print("Writing digital output ");
+          Serial.print(i);
+          Serial.print(": ");
+          Serial.print(output_values_to_digital[i]);
+          Serial.println("");
+        }
       }
-      digitalWrite(pins_digital_output[i], output_values_to_digital[i]);
+
+      // an interrupt may write other pins on the same port, so do not let it in between
+      uint8_t old_SREG = SREG;
+      cli();
+      *port = (*port & ~clear) | set;
+      SREG = old_SREG;
+    }
+  }
+
+  void write_outputs() {
+
+    // write analog output (only to the DACs the board has)
+    if (Board::has_dac_a) {
+      DAC1.send_to_channel_A(output_values_to_dac[0]);
+      DAC1.send_to_channel_B(output_values_to_dac[1]);
+    }
+    if (Board::has_dac_b) {
+      DAC2.send_to_channel_A(output_values_to_dac[2]);
+      DAC2.send_to_channel_B(output_values_to_dac[3]);
+    }
+
+    write_digital_outputs();
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Run the audio and control rate hooks, in order
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void run_audio_tick() {
+    if (control_countdown == 0) {
+      control_countdown = control_divider;
+      derived().on_control_do();
+    }
+    control_countdown--;
+    derived().on_audio_do();
+  }
+
+  void run_rate_events() {
+    if (audio_period_micros == 0) {
+      run_audio_tick();
+      return;
+    }
+    for (int i = 0; i < EUROSTEP_MAX_AUDIO_TICKS; i++) {
+      if (audio_timer.get_timer() < audio_period_micros) return;
+      audio_timer.advance_timer(audio_period_micros);  // absolute, so the rate does not drift
+      run_audio_tick();
+      write_outputs();  // each tick's sample goes out now, not at the end of the step
+    }
+    if (audio_timer.get_timer() >= audio_period_micros) {
+      audio_timer.reset_timer();  // too far behind to catch up, so drop the missed ticks
     }
   }
 
@@ -288,7 +419,9 @@ public:
 
   void start() {
     initialise_pins();
-    on_start_do();
+    audio_timer.use_micros();
+    derived().on_start_do();
+    audio_timer.reset_timer();
   }
 
   void step() {
@@ -297,8 +430,28 @@ public:
     read_switches();
     run_clock_events();
     run_clock_2_events();
-    on_step_do();
+    run_rate_events();
+    derived().on_step_do();
     write_outputs();
     if (debug) delay(250);
   }
 };
+
+// the same, with virtual hooks, for programs written before EuroStepT
+template<class Board>
+class EuroStepBoard : public EuroStepT<EuroStepBoard<Board>, Board> {
+
+public:
+
+  virtual void on_start_do() {}
+  virtual void on_clock_rise_do() {}
+  virtual void on_clock_fall_do() {}
+  virtual void on_clock_2_rise_do() {}
+  virtual void on_clock_2_fall_do() {}
+  virtual void on_step_do() {}
+  virtual void on_audio_do() {}
+  virtual void on_control_do() {}
+};
+
+// the board chosen by the hardware header (e.g., 'hardware/rasa6-ao.h')
+class EuroStep : public EuroStepBoard<Hardware> {};
@@ -0,0 +1,138 @@
+/*
+Class Name: ClockMultiplier
+
+Purpose: Play a number of evenly spaced pulses for every pulse of an incoming clock.
+
+Dependencies: None.
+
+Use: Create an instance of the class and configure settings, then run:
+-- clock_rise(): call when the incoming clock rises (e.g., from on_clock_rise_do())
+-- run_multiplier(): call as often as possible, returns whether the output is high
+-- get_output(): returns whether the output is high, without running
+
+You may wish to configure the following settings:
+-- set_multiplier(value): how many pulses to play for each clock pulse (default: 2)
+-- -- note: a new value is used from the next clock rise, so the phase is kept
+-- set_pulse_width(percent): how much of each pulse is high (default: 50)
+
+Edges are timed in micros, and the clock period is the average of the last 4 periods, so one
+late edge barely moves the output. A big change (e.g., a new tempo) is taken at once instead.
+Each pulse is scheduled at an absolute time (edge + k * period / multiplier, without rounding
+error building up), and every clock rise restarts the pulses from that edge. So the output
+stays locked to the clock, even for long multiplications.
+*/
+
+#define CLOCK_MULTIPLIER_HISTORY 4  // must be a power of 2
+
+class ClockMultiplier {
+
+private:
+
+  // incoming clock
+  bool edge_seen = false;
+  unsigned long last_edge_micros = 0;
+  unsigned long periods[CLOCK_MULTIPLIER_HISTORY];
+  int periods_known = 0;
+  int next_period = 0;
+  unsigned long period_micros = 0;
+
+  // settings
+  int multiplier = 2;
+  int pulse_width = 50;
+
+  // outgoing pulses
+  int active_multiplier = 2;
+  int pulses_left = 0;
+  unsigned long next_pulse_micros = 0;
+  unsigned long pulse_off_micros = 0;
+  unsigned long sub_period = 0;
+  int sub_remainder = 0;  // the period does not always divide evenly...
+  int remainder_sum = 0;  // ...so spread the leftover micros over the pulses
+  unsigned long high_micros = 0;
+  bool output = false;
+
+  void add_period(unsigned long value) {
+
+    // far from the average, so take the new period at once (e.g., a new tempo)
+    if (periods_known > 0 && (value > period_micros + period_micros / 2 || value < period_micros / 2)) {
+      periods_known = 0;
+    }
+
+    periods[next_period] = value;
+    next_period = (next_period + 1) & (CLOCK_MULTIPLIER_HISTORY - 1);
+    if (periods_known < CLOCK_MULTIPLIER_HISTORY) periods_known++;
+    if (periods_known == 1) {
+      for (int i = 0; i < CLOCK_MULTIPLIER_HISTORY; i++) periods[i] = value;
+    }
+
+    unsigned long sum = 0;
+    for (int i = 0; i < CLOCK_MULTIPLIER_HISTORY; i++) sum += periods[i];
+    period_micros = sum / CLOCK_MULTIPLIER_HISTORY;
+  }
+
+public:
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Getters and setters
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void set_multiplier(int value) {
+    if (value < 1) value = 1;
+    multiplier = value;
+  }
+
+  void set_pulse_width(int percent) {
+    if (percent < 1) percent = 1;
+    if (percent > 99) percent = 99;
+    pulse_width = percent;
+  }
+
+  bool get_output() {
+    return output;
+  }
+
+  unsigned long get_period() {
+    return period_micros;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Run the multiplier
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void clock_rise() {
+    unsigned long now = micros();
+    if (edge_seen) add_period(now - last_edge_micros);
+    edge_seen = true;
+    last_edge_micros = now;
+    if (period_micros == 0) return;  // wait for a second edge
+
+    // restart the pulses from this edge (the only divisions, once per edge)
+    active_multiplier = multiplier;
+    sub_period = period_micros / active_multiplier;
+    sub_remainder = period_micros % active_multiplier;
+    remainder_sum = 0;
+    high_micros = sub_period * pulse_width / 100;
+    if (high_micros == 0) high_micros = 1;
+    next_pulse_micros = now;
+    pulses_left = active_multiplier;
+  }
+
+  bool run_multiplier() {
+    unsigned long now = micros();
+    if (output && (long)(now - pulse_off_micros) >= 0) {
+      output = false;
+    }
+    if (pulses_left > 0 && (long)(now - next_pulse_micros) >= 0) {
+      output = true;
+      pulse_off_micros = next_pulse_micros + high_micros;
+      pulses_left--;
+      next_pulse_micros += sub_period;
+      remainder_sum += sub_remainder;
+      if (remainder_sum >= active_multiplier) {
+        remainder_sum -= active_multiplier;
+        next_pulse_micros++;
+      }
+    }
+    return output;
+  }
+};
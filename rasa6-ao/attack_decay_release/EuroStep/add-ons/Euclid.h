@@ -0,0 +1,187 @@
+/*
+Class Name: Euclid
+
+Purpose: Play Euclidean rhythms (events spread as evenly as possible over a number of steps).
+
+Dependencies: None.
+
+Use: Create an instance of the class and configure settings, then run:
+-- set_pattern(events, steps): choose the rhythm (steps is 1-32 and events is 0-steps)
+-- next_step(): move to the next step (e.g., on the clock rise), returns whether it has an event
+-- is_event(): returns whether the current step has an event
+
+You may also want other options:
+-- set_rotation(value): rotate the rhythm by a number of steps
+-- reset_step(): go back to the first step, so the next call to next_step() plays it
+-- get_step(): returns the current step (0 to steps - 1)
+-- get_pattern(): returns the rotated rhythm, where step i is bit i
+
+Every rhythm is read from a table in flash (made by 'tools/euclid_table.py'), and it is
+rotated once when the settings change. So each step is a single bit test, and calling
+set_pattern() every loop costs almost nothing when nothing has changed.
+*/
+
+#define EUCLID_MAX_STEPS 32
+
+// generated by 'tools/euclid_table.py', so do not edit by hand
+const uint32_t euclid_patterns[] PROGMEM = {
+  0x00000000UL, 0x00000001UL,  // steps = 1
+  0x00000000UL, 0x00000001UL, 0x00000003UL,  // steps = 2
+  0x00000000UL, 0x00000001UL, 0x00000003UL, 0x00000007UL,  // steps = 3
+  0x00000000UL, 0x00000001UL, 0x00000005UL, 0x00000007UL, 0x0000000FUL,  // steps = 4
+  0x00000000UL, 0x00000001UL, 0x00000005UL, 0x00000015UL, 0x0000000FUL, 0x0000001FUL,  // steps = 5
+  0x00000000UL, 0x00000001UL, 0x00000009UL, 0x00000015UL, 0x0000002DUL, 0x0000001FUL, 0x0000003FUL,  // steps = 6
+  0x00000000UL, 0x00000001UL, 0x00000009UL, 0x00000015UL, 0x00000055UL, 0x0000006DUL, 0x0000003FUL, 0x0000007FUL,  // steps = 7
+  0x00000000UL, 0x00000001UL, 0x00000011UL, 0x00000049UL, 0x00000055UL, 0x0000006DUL, 0x000000DDUL, 0x0000007FUL,  // steps = 8
+  0x000000FFUL,
+  0x00000000UL, 0x00000001UL, 0x00000011UL, 0x00000049UL, 0x00000055UL, 0x00000155UL, 0x0000016DUL, 0x000001DDUL,  // steps = 9
+  0x000000FFUL, 0x000001FFUL,
+  0x00000000UL, 0x00000001UL, 0x00000021UL, 0x00000049UL, 0x00000129UL, 0x00000155UL, 0x000001ADUL, 0x0000036DUL,  // steps = 10
+  0x000003BDUL, 0x000001FFUL, 0x000003FFUL,
+  0x00000000UL, 0x00000001UL, 0x00000021UL, 0x00000111UL, 0x00000249UL, 0x00000155UL, 0x00000555UL, 0x0000036DUL,  // steps = 11
+  0x000005DDUL, 0x000007BDUL, 0x000003FFUL, 0x000007FFUL,
+  0x00000000UL, 0x00000001UL, 0x00000041UL, 0x00000111UL, 0x00000249UL, 0x00000529UL, 0x00000555UL, 0x000005ADUL,  // steps = 12
+  0x00000B6DUL, 0x00000DDDUL, 0x00000F7DUL, 0x000007FFUL, 0x00000FFFUL,
+  0x00000000UL, 0x00000001UL, 0x00000041UL, 0x00000111UL, 0x00000249UL, 0x00000529UL, 0x00000555UL, 0x00001555UL,  // steps = 13
+  0x000015ADUL, 0x00001B6DUL, 0x00001DDDUL, 0x00001F7DUL, 0x00000FFFUL, 0x00001FFFUL,
+  0x00000000UL, 0x00000001UL, 0x00000081UL, 0x00000421UL, 0x00000891UL, 0x00001249UL, 0x000014A9UL, 0x00001555UL,  // steps = 14
+  0x000016ADUL, 0x00001B6DUL, 0x00002EDDUL, 0x000037BDUL, 0x00003EFDUL, 0x00001FFFUL, 0x00003FFFUL,
+  0x00000000UL, 0x00000001UL, 0x00000081UL, 0x00000421UL, 0x00001111UL, 0x00001249UL, 0x00002529UL, 0x00001555UL,  // steps = 15
+  0x00005555UL, 0x000035ADUL, 0x00005B6DUL, 0x00005DDDUL, 0x000077BDUL, 0x00007EFDUL, 0x00003FFFUL, 0x00007FFFUL,
+  0x00000000UL, 0x00000001UL, 0x00000101UL, 0x00000421UL, 0x00001111UL, 0x00001249UL, 0x00002929UL, 0x000054A9UL,  // steps = 16
+  0x00005555UL, 0x000056ADUL, 0x0000ADADUL, 0x0000DB6DUL, 0x0000DDDDUL, 0x0000F7BDUL, 0x0000FDFDUL, 0x00007FFFUL,
+  0x0000FFFFUL,
+  0x00000000UL, 0x00000001UL, 0x00000101UL, 0x00001041UL, 0x00001111UL, 0x00004891UL, 0x00009249UL, 0x0000A529UL,  // steps = 17
+  0x00005555UL, 0x00015555UL, 0x0000B5ADUL, 0x0000DB6DUL, 0x00016EDDUL, 0x0001DDDDUL, 0x0001DF7DUL, 0x0001FDFDUL,
+  0x0000FFFFUL, 0x0001FFFFUL,
+  0x00000000UL, 0x00000001UL, 0x00000201UL, 0x00001041UL, 0x00004221UL, 0x00004891UL, 0x00009249UL, 0x0000A529UL,  // steps = 18
+  0x000152A9UL, 0x00015555UL, 0x00015AADUL, 0x0002B5ADUL, 0x0002DB6DUL, 0x00036EDDUL, 0x00037BBDUL, 0x0003DF7DUL,
+  0x0003FBFDUL, 0x0001FFFFUL, 0x0003FFFFUL,
+  0x00000000UL, 0x00000001UL, 0x00000201UL, 0x00001041UL, 0x00008421UL, 0x00011111UL, 0x00009249UL, 0x00012929UL,  // steps = 19
+  0x000254A9UL, 0x00015555UL, 0x00055555UL, 0x000356ADUL, 0x0005ADADUL, 0x0006DB6DUL, 0x0005DDDDUL, 0x0006F7BDUL,
+  0x0007DF7DUL, 0x0007FBFDUL, 0x0003FFFFUL, 0x0007FFFFUL,
+  0x00000000UL, 0x00000001UL, 0x00000401UL, 0x00004081UL, 0x00008421UL, 0x00011111UL, 0x00024491UL, 0x00049249UL,  // steps = 20
+  0x0004A529UL, 0x000552A9UL, 0x00055555UL, 0x00055AADUL, 0x0006B5ADUL, 0x0006DB6DUL, 0x000B76DDUL, 0x000DDDDDUL,
+  0x000EF7BDUL, 0x000F7EFDUL, 0x000FF7FDUL, 0x0007FFFFUL, 0x000FFFFFUL,
+  0x00000000UL, 0x00000001UL, 0x00000401UL, 0x00004081UL, 0x00008421UL, 0x00011111UL, 0x00044891UL, 0x00049249UL,  // steps = 21
+  0x00092929UL, 0x000A54A9UL, 0x00055555UL, 0x00155555UL, 0x000B56ADUL, 0x000DADADUL, 0x0016DB6DUL, 0x00176EDDUL,
+  0x001DDDDDUL, 0x001EF7BDUL, 0x001F7EFDUL, 0x001FF7FDUL, 0x000FFFFFUL, 0x001FFFFFUL,
+  0x00000000UL, 0x00000001UL, 0x00000801UL, 0x00004081UL, 0x00020841UL, 0x00044221UL, 0x00048891UL, 0x00049249UL,  // steps = 22
+  0x00094929UL, 0x0014A529UL, 0x00154AA9UL, 0x00155555UL, 0x00156AADUL, 0x0016B5ADUL, 0x002D6DADUL, 0x0036DB6DUL,
+  0x0036EEDDUL, 0x00377BBDUL, 0x003BEF7DUL, 0x003F7EFDUL, 0x003FEFFDUL, 0x001FFFFFUL, 0x003FFFFFUL,
+  0x00000000UL, 0x00000001UL, 0x00000801UL, 0x00010101UL, 0x00041041UL, 0x00044221UL, 0x00111111UL, 0x00124491UL,  // steps = 23
+  0x00249249UL, 0x0014A529UL, 0x002A54A9UL, 0x00155555UL, 0x00555555UL, 0x002B56ADUL, 0x0056B5ADUL, 0x0036DB6DUL,
+  0x005B76DDUL, 0x005DDDDDUL, 0x00777BBDUL, 0x0077DF7DUL, 0x007DFDFDUL, 0x007FEFFDUL, 0x003FFFFFUL, 0x007FFFFFUL,
+  0x00000000UL, 0x00000001UL, 0x00001001UL, 0x00010101UL, 0x00041041UL, 0x00108421UL, 0x00111111UL, 0x00244891UL,  // steps = 24
+  0x00249249UL, 0x00292929UL, 0x004A94A9UL, 0x00554AA9UL, 0x00555555UL, 0x00556AADUL, 0x006AD6ADUL, 0x00ADADADUL,
+  0x00B6DB6DUL, 0x00B76EDDUL, 0x00DDDDDDUL, 0x00DEF7BDUL, 0x00F7DF7DUL, 0x00FDFDFDUL, 0x00FFDFFDUL, 0x007FFFFFUL,
+  0x00FFFFFFUL,
+  0x00000000UL, 0x00000001UL, 0x00001001UL, 0x00010101UL, 0x00041041UL, 0x00108421UL, 0x00111111UL, 0x00244891UL,  // steps = 25
+  0x00249249UL, 0x00494929UL, 0x0094A529UL, 0x00A552A9UL, 0x00555555UL, 0x01555555UL, 0x00B55AADUL, 0x00D6B5ADUL,
+  0x016D6DADUL, 0x01B6DB6DUL, 0x01B76EDDUL, 0x01DDDDDDUL, 0x01DEF7BDUL, 0x01F7DF7DUL, 0x01FDFDFDUL, 0x01FFDFFDUL,
+  0x00FFFFFFUL, 0x01FFFFFFUL,
+  0x00000000UL, 0x00000001UL, 0x00002001UL, 0x00040201UL, 0x00102081UL, 0x00108421UL, 0x00442221UL, 0x00448891UL,  // steps = 26
+  0x00922491UL, 0x01249249UL, 0x01252929UL, 0x012A54A9UL, 0x01552AA9UL, 0x01555555UL, 0x0155AAADUL, 0x01AB56ADUL,
+  0x01B5ADADUL, 0x01B6DB6DUL, 0x02DBB6DDUL, 0x0376EEDDUL, 0x0377BBBDUL, 0x03DEF7BDUL, 0x03DFBEFDUL, 0x03F7FBFDUL,
+  0x03FFBFFDUL, 0x01FFFFFFUL, 0x03FFFFFFUL,
+  0x00000000UL, 0x00000001UL, 0x00002001UL, 0x00040201UL, 0x00204081UL, 0x00420841UL, 0x00844221UL, 0x01111111UL,  // steps = 27
+  0x01124491UL, 0x01249249UL, 0x01292929UL, 0x0294A529UL, 0x02A552A9UL, 0x01555555UL, 0x05555555UL, 0x02B55AADUL,
+  0x02D6B5ADUL, 0x05ADADADUL, 0x05B6DB6DUL, 0x05DB76DDUL, 0x05DDDDDDUL, 0x06F77BBDUL, 0x077BEF7DUL, 0x07BF7EFDUL,
+  0x07F7FBFDUL, 0x07FFBFFDUL, 0x03FFFFFFUL, 0x07FFFFFFUL,
+  0x00000000UL, 0x00000001UL, 0x00004001UL, 0x00040201UL, 0x00204081UL, 0x00420841UL, 0x00884221UL, 0x01111111UL,  // steps = 28
+  0x02244891UL, 0x01249249UL, 0x024A4929UL, 0x0294A529UL, 0x052A54A9UL, 0x05552AA9UL, 0x05555555UL, 0x0555AAADUL,
+  0x05AB56ADUL, 0x0AD6B5ADUL, 0x0B6B6DADUL, 0x0DB6DB6DUL, 0x0BB76EDDUL, 0x0DDDDDDDUL, 0x0EEF7BBDUL, 0x0F7BEF7DUL,
+  0x0FBF7EFDUL, 0x0FF7FBFDUL, 0x0FFF7FFDUL, 0x07FFFFFFUL, 0x0FFFFFFFUL,
+  0x00000000UL, 0x00000001UL, 0x00004001UL, 0x00100401UL, 0x00204081UL, 0x01041041UL, 0x02108421UL, 0x01111111UL,  // steps = 29
+  0x04448891UL, 0x04922491UL, 0x09249249UL, 0x09292929UL, 0x094A94A9UL, 0x0AA552A9UL, 0x05555555UL, 0x15555555UL,
+  0x0AB55AADUL, 0x0D6AD6ADUL, 0x0DADADADUL, 0x0DB6DB6DUL, 0x16DBB6DDUL, 0x1776EEDDUL, 0x1DDDDDDDUL, 0x1BDEF7BDUL,
+  0x1DF7DF7DUL, 0x1FBF7EFDUL, 0x1FDFF7FDUL, 0x1FFF7FFDUL, 0x0FFFFFFFUL, 0x1FFFFFFFUL,
+  0x00000000UL, 0x00000001UL, 0x00008001UL, 0x00100401UL, 0x00808101UL, 0x01041041UL, 0x02108421UL, 0x04442221UL,  // steps = 30
+  0x04488891UL, 0x09124491UL, 0x09249249UL, 0x0A494929UL, 0x1294A529UL, 0x152A54A9UL, 0x1554AAA9UL, 0x15555555UL,
+  0x1556AAADUL, 0x15AB56ADUL, 0x1AD6B5ADUL, 0x2B6D6DADUL, 0x2DB6DB6DUL, 0x2DDB76DDUL, 0x376EEEDDUL, 0x3777BBBDUL,
+  0x3BDEF7BDUL, 0x3DF7DF7DUL, 0x3EFEFDFDUL, 0x3FDFF7FDUL, 0x3FFEFFFDUL, 0x1FFFFFFFUL, 0x3FFFFFFFUL,
+  0x00000000UL, 0x00000001UL, 0x00008001UL, 0x00100401UL, 0x01010101UL, 0x01041041UL, 0x02108421UL, 0x08844221UL,  // steps = 31
+  0x11111111UL, 0x12244891UL, 0x09249249UL, 0x124A4929UL, 0x25252929UL, 0x294A94A9UL, 0x2A554AA9UL, 0x15555555UL,
+  0x55555555UL, 0x2B556AADUL, 0x2D6AD6ADUL, 0x35B5ADADUL, 0x5B6B6DADUL, 0x6DB6DB6DUL, 0x5BB76EDDUL, 0x5DDDDDDDUL,
+  0x6EF77BBDUL, 0x7BDEF7BDUL, 0x7DF7DF7DUL, 0x7DFDFDFDUL, 0x7FDFF7FDUL, 0x7FFEFFFDUL, 0x3FFFFFFFUL, 0x7FFFFFFFUL,
+  0x00000000UL, 0x00000001UL, 0x00010001UL, 0x00400801UL, 0x01010101UL, 0x04102081UL, 0x08410841UL, 0x08844221UL,  // steps = 32
+  0x11111111UL, 0x12244891UL, 0x24912491UL, 0x49249249UL, 0x29292929UL, 0x5294A529UL, 0x52A952A9UL, 0x5554AAA9UL,
+  0x55555555UL, 0x5556AAADUL, 0x5AAD5AADUL, 0x5AD6B5ADUL, 0xADADADADUL, 0x6DB6DB6DUL, 0xB6DDB6DDUL, 0xDBB76EDDUL,
+  0xDDDDDDDDUL, 0xEEF77BBDUL, 0xEF7DEF7DUL, 0xF7DFBEFDUL, 0xFDFDFDFDUL, 0xFF7FEFFDUL, 0xFFFDFFFDUL, 0x7FFFFFFFUL,
+  0xFFFFFFFFUL,
+};
+
+class Euclid {
+
+private:
+
+  int events = 0;
+  int steps = 1;
+  int rotation = 0;  // wrapped to 0 to steps - 1 when the pattern is loaded
+  int current_step = -1;  // so the first next_step() plays step 0
+  uint32_t pattern = 0;
+
+  // the patterns for n steps follow those for 1 to n - 1 steps (which have 2 to n entries)
+  void load_pattern() {
+    int index = (steps - 1) * (steps + 2) / 2 + events;
+    uint32_t value = pgm_read_dword(euclid_patterns + index);
+    int shift = rotation % steps;
+    if (shift < 0) shift += steps;
+    if (shift > 0) {
+      value = (value >> shift) | (value << (steps - shift));  // shift is never 0 or steps here
+      if (steps < 32) value &= (1UL << steps) - 1;
+    }
+    pattern = value;
+  }
+
+public:
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Getters and setters
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void set_pattern(int new_events, int new_steps) {
+    if (new_steps < 1) new_steps = 1;
+    if (new_steps > EUCLID_MAX_STEPS) new_steps = EUCLID_MAX_STEPS;
+    if (new_events < 0) new_events = 0;
+    if (new_events > new_steps) new_events = new_steps;
+    if (new_events == events && new_steps == steps) return;
+    events = new_events;
+    steps = new_steps;
+    if (current_step >= steps) current_step = current_step % steps;
+    load_pattern();
+  }
+
+  // the first step plays step 'value' of the rhythm (e.g., 1 makes x..x..x. into ..x..x.x)
+  void set_rotation(int value) {
+    if (value == rotation) return;
+    rotation = value;
+    load_pattern();
+  }
+
+  int get_step() {
+    return (current_step < 0) ? 0 : current_step;
+  }
+
+  uint32_t get_pattern() {
+    return pattern;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Play the rhythm
+  ///////////////////////////////////////////////////////////////////////////////
+
+  bool is_event() {
+    return (pattern >> get_step()) & 1;
+  }
+
+  bool next_step() {
+    current_step++;
+    if (current_step >= steps) current_step = 0;
+    return is_event();
+  }
+
+  void reset_step() {
+    current_step = -1;
+  }
+};
@@ -7,22 +7,56 @@ Dependencies: None.
 
 Use: Create an instance of the class and configure settings, then run:
 -- set_inputs(array_1, array_2, length): point the class to the input arrays
+-- -- or set_inputs_from_flash(array_1, array_2, length) for arrays saved in PROGMEM
 -- set_output(array_3): point the class to where to save the result
 -- interpolate(pct): interpolate between the two arrays (as a percent)
 -- get_output_at(index): get the interpolated value at an index
+
+You may wish to configure the following settings:
+-- interpolate_by_weight(weight): interpolate using an 8.8 fixed-point weight (0-256)
+-- -- note: interpolate(pct) is the same as a weight of pct * 256 / 100
+-- enable_lazy_output(): only blend the value asked for by get_output_at(index)
+-- -- note: no output array is needed, and each call costs one blend
+-- disable_lazy_output(): blend the whole output array when the weight changes (default)
+
+Interpolating again with the same weight does nothing, so it is safe to call every step.
+The input arrays are not owned by this class, so they are never deleted.
 */
 
 class Interpolate {
 
 private:
 
-  byte* sample_1;
-  byte* sample_2;
+  const byte* sample_1;
+  const byte* sample_2;
   int sample_length = 0;
-  int current_percentage = 0;
-  double scale = 0;
+  bool samples_in_flash = false;
+  int current_percentage = -1;
+  unsigned int weight = 0;  // how much of sample_2 to use, from 0 to 256
+  bool output_is_stale = true;
+  bool lazy_output = false;
   byte* output;
 
+  byte blend(byte value_1, byte value_2) {
+    return ((unsigned int)value_1 * (256 - weight) + (unsigned int)value_2 * weight + 128) >> 8;
+  }
+
+  byte blend_at(int index) {
+    if (samples_in_flash) return blend(pgm_read_byte(sample_1 + index), pgm_read_byte(sample_2 + index));
+    return blend(sample_1[index], sample_2[index]);
+  }
+
+  void apply_weight(unsigned int new_weight) {
+    if (new_weight > 256) new_weight = 256;
+    if (new_weight == weight && !output_is_stale) return;
+    weight = new_weight;
+    output_is_stale = false;
+    if (lazy_output) return;
+    for (int i = 0; i < sample_length; i++) {
+      output[i] = blend_at(i);
+    }
+  }
+
 public:
 
   ///////////////////////////////////////////////////////////////////////////////
@@ -33,31 +67,54 @@ public:
     sample_1 = array_1;
     sample_2 = array_2;
     sample_length = length;
+    samples_in_flash = false;
+    output_is_stale = true;
+  }
+
+  void set_inputs_from_flash(const byte* array_1, const byte* array_2, int length) {
+    sample_1 = array_1;
+    sample_2 = array_2;
+    sample_length = length;
+    samples_in_flash = true;
+    output_is_stale = true;
   }
 
   void set_output(byte* array_3) {
     output = array_3;
+    output_is_stale = true;
   }
 
-  byte get_output_at(int index) {
-    return output[index];
+  void enable_lazy_output() {
+    lazy_output = true;
+  }
+
+  void disable_lazy_output() {
+    lazy_output = false;
+    output_is_stale = true;
   }
 
-  ~Interpolate() {
-    delete[] sample_1;
-    delete[] sample_2;
+  byte get_output_at(int index) {
+    if (lazy_output) return blend_at(index);
+    return output[index];
   }
 
   ///////////////////////////////////////////////////////////////////////////////
   /// Do the work
   ///////////////////////////////////////////////////////////////////////////////
 
+  void interpolate_by_weight(unsigned int new_weight) {
+    current_percentage = -1;  // so the next interpolate(pct) sets its own weight
+    apply_weight(new_weight);
+  }
+
   void interpolate(int pct) {
     if (pct < 0) pct = 0;
     if (pct > 100) pct = 100;
-    scale = pct / 100.0;
-    for (int i = 0; i < sample_length; i++) {
-      output[i] = (1 - scale) * sample_1[i] + scale * sample_2[i];
+    if (pct != current_percentage) {
+      current_percentage = pct;
+      apply_weight((((unsigned int)pct << 8) + 50) / 100);
+    } else {
+      apply_weight(weight);  // only does work if the inputs or output changed
     }
   }
 };
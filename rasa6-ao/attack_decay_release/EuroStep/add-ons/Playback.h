@@ -3,10 +3,14 @@ Class Name: Playback
 
 Purpose: To manage the playback of a WAV file saved as a C++ array object.
 
-Dependencies: This class inherits from the Timer class.
+Dependencies: This class inherits from the Timer class, decodes with the Adpcm class and reads from the Interpolate class.
+-- note: include 'Interpolate.h' before 'Playback.h'
 
 Use: Create an instance of the class and configure settings, then run:
 -- set_audio(audio_array, audio_array_length): associate Playback with another C++ array
+-- -- or set_audio_from_flash(audio_array, audio_array_length) for an array saved in PROGMEM
+-- -- or set_adpcm_audio(adpcm_array, number_of_values) for 4-bit audio from 'tools/adpcm_encode.py'
+-- -- or set_audio_source(source, audio_array_length) to read through Interpolate (e.g., a WavetableBank)
 -- run_playback(): advance the timer to update the current Playback position
 -- -- note: run_playback() will not play if Playback is paused
 -- get_current_value(): return the value associated with the current Playback position
@@ -23,11 +27,18 @@ You may also want other Playback options:
 
 You may wish to configure the following settings:
 -- set_playback_rate(value): set the rate for each step change for Playback
--- set_playback_step(value): set the size of each step change for Playback
+-- set_playback_step(value, fraction): set the size of each step change for Playback
+-- -- note: fraction is in 1/65536ths of a value, so steps can be fractional
 -- set_start_position(value): change the start position for Playback
 
 You can also play wavetables at a specific pitch:
 -- set_playback_rate_from_Hz(Hz, values_per_cycle): for pitch in Hz
+-- -- note: the remainder of the whole-micros rate is carried by a fractional step
+-- enable_interpolation(): blend neighbouring values by the fractional position
+-- disable_interpolation(): use the nearest lower value only (default)
+-- set_mipmapped_audio(mipmap_array, values_per_level, number_of_levels): for band-limited
+-- -- wavetables from 'tools/wavetable_mipmaps.py', which avoid aliasing at high pitch
+-- -- note: the level is picked whenever the step changes, so costs nothing per value
 
 The following settings are relevant from the Timer class:
 -- use_millis(): use milliseconds as the time units for the set_ADSR_rate (default)
@@ -43,14 +54,29 @@ private:
 
   // how much to speed up playback (optional)
   int playback_step = 1;
+  uint16_t playback_step_fraction = 0;  // in 1/65536ths of a value
 
-  // load a reference "file" to sample
-  byte* audio;
+  // fastest rate allowed when playing at pitch (in micros)
+  int min_playback_rate_micros = 20;
+
+  // load a reference "file" to sample (Playback only points to it, the sketch owns the array)
+  const byte* audio = nullptr;
   int audio_length = 0;
+  bool audio_in_flash = false;
+  bool audio_is_adpcm = false;
+  Adpcm Decoder;
+
+  // read through a blend of other arrays (optional)
+  Interpolate* audio_source = nullptr;
+
+  // band-limited copies of one wavetable, each an octave apart (optional)
+  const byte* mipmap = nullptr;
+  int number_of_mip_levels = 0;
 
   // the position along the playback reference file
   int current_value = 0;
   int current_position = 0;
+  uint16_t current_fraction = 0;  // how far between current_position and the next value
   int start_position = 0;
 
   // other args
@@ -58,12 +84,50 @@ private:
   int safe_restart_increment = 16;
   bool pause = false;
   bool loop = false;
+  bool interpolate_values = false;
 
   void loop_now() {
-    rewind_playback();
+    // wrap by the overshoot instead of rewinding, so looped wavetables keep their pitch
+    current_position = start_position + (current_position - audio_length);
+    if (current_position >= audio_length) current_position = start_position;
     unpause_playback();
   }
 
+  void advance_position() {
+    uint16_t last_fraction = current_fraction;
+    current_fraction += playback_step_fraction;
+    current_position += playback_step;
+    if (current_fraction < last_fraction) current_position += 1;  // fraction carried over
+  }
+
+  // level k has no harmonics above values_per_cycle / 2^(k+1), so it does not alias
+  //  while each step covers at most 2^k values
+  void select_mip_level() {
+    if (mipmap == nullptr) return;
+    unsigned long step = ((unsigned long)playback_step << 16) | playback_step_fraction;
+    int level = 0;
+    while (level < number_of_mip_levels - 1 && (1UL << (16 + level)) < step) level++;
+    audio = mipmap + (long)level * audio_length;  // all levels share the same length and position
+  }
+
+  int read_audio(int index) {
+    if (audio_source != nullptr) return audio_source->get_output_at(index);
+    if (audio_is_adpcm) return Decoder.get_value_at(index);
+    if (audio_in_flash) return pgm_read_byte(audio + index);
+    return audio[index];
+  }
+
+  int get_value_at_position() {
+    int value = read_audio(current_position);
+    if (interpolate_values) {
+      int next_position = current_position + 1;
+      if (next_position >= audio_length) next_position = loop ? start_position : current_position;
+      int next_value = read_audio(next_position);
+      value += (long)(next_value - value) * (current_fraction >> 8) >> 8;  // 8-bit weight is plenty for byte audio
+    }
+    return value;
+  }
+
 public:
 
   ///////////////////////////////////////////////////////////////////////////////
@@ -71,6 +135,7 @@ public:
   ///////////////////////////////////////////////////////////////////////////////
 
   void set_playback_rate(int value) {
+    if (value < 1) value = 1;  // timer must move before the position can
     playback_rate = value;
   }
 
@@ -78,20 +143,70 @@ public:
   void set_playback_rate_from_Hz(int Hz, int values_per_cycle) {
     use_micros();  // force use micro-seconds
     playback_rate = map_Hz_to_micros(Hz) / values_per_cycle;
+    if (playback_rate < min_playback_rate_micros) playback_rate = min_playback_rate_micros;
+
+    // whole micros truncate the pitch (e.g., 35.5 us becomes 35 us at 440 Hz and 64 values),
+    //  so step by however many values actually pass in one playback_rate
+    float values_per_step = 1.0e-6 * Hz * values_per_cycle * playback_rate;
+    playback_step = values_per_step;
+    playback_step_fraction = (values_per_step - playback_step) * 65536.0;
+    select_mip_level();
   }
 
-  void set_playback_step(int value) {
+  void set_playback_step(int value, uint16_t fraction = 0) {
     playback_step = value;
+    playback_step_fraction = fraction;
+    select_mip_level();
+  }
+
+  void enable_interpolation() {
+    interpolate_values = true;
+  }
+
+  void disable_interpolation() {
+    interpolate_values = false;
   }
 
   void set_audio(byte* audio_array, int audio_array_length) {
     audio = audio_array;  // just point to new file, which will already live in RAM
     audio_length = audio_array_length;
+    audio_in_flash = false;
+    audio_is_adpcm = false;
+    audio_source = nullptr;
+    mipmap = nullptr;
     safe_restart_increment = 16;  // tested for sample values 0-255
   }
 
+  void set_audio_from_flash(const byte* audio_array, int audio_array_length) {
+    set_audio(nullptr, audio_array_length);
+    audio = audio_array;
+    audio_in_flash = true;
+  }
+
+  // each byte holds two values, so number_of_values is twice the array length
+  void set_adpcm_audio(const byte* adpcm_array, int number_of_values) {
+    set_audio_from_flash(adpcm_array, number_of_values);
+    audio_is_adpcm = true;
+    Decoder.set_data(adpcm_array);
+    Decoder.set_loop_point(start_position);
+  }
+
+  void set_audio_source(Interpolate* source, int audio_array_length) {
+    set_audio(nullptr, audio_array_length);
+    audio_source = source;
+  }
+
+  void set_mipmapped_audio(const byte* mipmap_array, int values_per_level, int number_of_levels) {
+    set_audio_from_flash(mipmap_array, values_per_level);
+    mipmap = mipmap_array;
+    number_of_mip_levels = number_of_levels;
+    select_mip_level();
+  }
+
   void set_start_position(int value) {
+    if (value == start_position) return;
     start_position = value;
+    if (audio_is_adpcm) Decoder.set_loop_point(start_position);  // so loops and restarts skip the decode from 0
   }
 
   int get_current_value() {
@@ -102,10 +217,6 @@ public:
     return now_restarting_safely;
   }
 
-  ~Playback() {
-    delete[] audio;
-  }
-
   ///////////////////////////////////////////////////////////////////////////////
   /// Playback functions
   ///////////////////////////////////////////////////////////////////////////////
@@ -129,6 +240,7 @@ public:
   void rewind_playback() {
     pause_playback();
     current_position = start_position;
+    current_fraction = 0;
     reset_timer();
   }
 
@@ -157,10 +269,15 @@ public:
   }
 
   void continue_playback() {
-    if (get_timer() > playback_rate) {
-      current_value = audio[current_position];
-      current_position += 1;  // increment after
-      reset_timer();
+    unsigned long time_passed = get_timer();
+    if (time_passed >= (unsigned long)playback_rate) {
+      current_value = get_value_at_position();
+      advance_position();  // increment after
+      if (time_passed < 2UL * playback_rate) {
+        advance_timer(playback_rate);  // keep steps evenly spaced despite loop jitter
+      } else {
+        reset_timer();  // too far behind to catch up, so start counting again
+      }
     }
   }
 
@@ -3,15 +3,42 @@ Class Name: Quantiser
 
 Purpose: Quantise CV.
 
-Dependencies: None.
+Dependencies: This class inherits from the Timer class.
 
 Use: Create an instance of the class and configure settings, then run:
 -- enable_note(j): Add j-th note to quantiser scale.
 -- disable_note(j): Remove j-th note from quantiser scale.
 -- run(int incoming_cv): Quantise the voltage (in mV).
 -- get_quantised_cv(): Get result.
+
+Each change to the scale rebuilds a table from incoming note number to quantised note,
+so run() is two multiply-shifts and one table lookup.
+
+You can also quantise to any tuning, such as a Scala file converted by 'tools/scl_to_header.py':
+-- load_tuning(mV_array, thresholds_mV_array, number_of_degrees): use a tuning saved in PROGMEM
+-- -- note: mV_array lists each degree in mV above the root, from 0 up to the period (degrees + 1 values)
+-- -- note: thresholds_mV_array lists the mV halfway between each degree and the next (degrees values)
+-- -- note: the period does not need to be an octave, and all degrees of the tuning are used
+-- unload_tuning(): go back to the 12-note scale set by enable_note() and disable_note()
+
+A loaded tuning stays in flash and is quantised by binary search over its thresholds, so
+run() costs O(log n) in integer math, even for 31- or 53-note tunings, and any number of
+degrees uses no extra RAM.
+
+You may wish to configure the following settings:
+-- set_hysteresis(mV): how far past a threshold the CV must go before the note changes
+-- -- note: this stops chatter between two notes when the CV sits near a threshold
+-- has_note_changed(): true if the last run() moved to a new note
+-- -- note: with no notes enabled the CV passes through, and a new note is a new nearest semitone
+-- get_trigger(): true for a short time after each note change (e.g., to write to a digital output)
+-- set_trigger_length(duration): how long the trigger stays high (default: 10 milliseconds)
 */
 
+// how many incoming note numbers to tabulate (64 notes covers 0-5.3 V)
+#ifndef QUANTISER_TABLE_SIZE
+#define QUANTISER_TABLE_SIZE 64
+#endif
+
 // Quantise note number to next nearest note number
 int find_nearest_note_in_scale(int note_number, bool scale[12]) {
 
@@ -32,7 +59,7 @@ int find_nearest_note_in_scale(int note_number, bool scale[12]) {
 
       // try the next note below in scale
       next_note_lower -= 1;
-      note_index = next_note_lower % 12;
+      note_index = (next_note_lower % 12 + 12) % 12;  // wrap below note 0 too
       if (scale[note_index]) {
         return next_note_lower;
       }
@@ -40,18 +67,95 @@ int find_nearest_note_in_scale(int note_number, bool scale[12]) {
   }
 }
 
-class Quantiser {
+class Quantiser : public Timer {
 
 private:
 
   bool scale[12] = { false };
-  int incoming_tone = 0;
-  int quantised_tone = 0;
   int quantised_cv = 0;
 
+  // used to hold the current note near a threshold
+  int hysteresis_mV = 0;
+  bool note_changed = false;
+  int current_note_mV = 0;  // the output note in mV (the nearest semitone when passing the CV through)
+
+  // used to send a trigger on each note change
+  unsigned long trigger_length = 10;
+  bool trigger_is_high = false;
+
+  // quantised note number for each incoming note number (a byte each, as notes stay below 128)
+  int8_t quantised_note_table[QUANTISER_TABLE_SIZE];
+
   // used to skip quantiser when no notes are set
-  int number_of_active_notes = 0;
-  bool nothing_to_quantise = false;
+  bool nothing_to_quantise = true;
+
+  // used to quantise to a loaded tuning (in PROGMEM), one period at a time
+  bool tuning_is_loaded = false;
+  const int* tuning_mV = nullptr;             // from 0 (the root) up to period_mV
+  const int* tuning_thresholds_mV = nullptr;  // midpoints between degrees
+  int number_of_degrees = 0;
+  int period_mV = 1000;
+  unsigned long period_reciprocal = 65;  // 2^16 / period_mV, to find the period without dividing
+
+  int quantise_to_tuning(int incoming_cv) {
+    if (incoming_cv < 0) incoming_cv = 0;
+
+    // the reciprocal is rounded down, so the period can be one too small (as in divide_by_byte())
+    int period = ((unsigned long)incoming_cv * period_reciprocal) >> 16;
+    int period_start_mV = period * period_mV;
+    int offset_mV = incoming_cv - period_start_mV;
+    if (offset_mV >= period_mV) {
+      period_start_mV += period_mV;
+      offset_mV -= period_mV;
+    }
+
+    // find how many thresholds lie at or below the offset
+    int low = 0;
+    int high = number_of_degrees;
+    while (low < high) {
+      int middle = (low + high) >> 1;
+      if (offset_mV >= (int)pgm_read_word(tuning_thresholds_mV + middle)) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    return period_start_mV + (int)pgm_read_word(tuning_mV + low);
+  }
+
+  bool is_passing_through() {
+    return nothing_to_quantise && !tuning_is_loaded;
+  }
+
+  // each quantised value is its own note, but passed through CV is rounded to a semitone,
+  //  in mV either way so that changing mode only triggers if the note really moves
+  int get_note_mV_of(int cv) {
+    return is_passing_through() ? map_note_number_to_mV(map_mV_to_note_number(cv)) : cv;
+  }
+
+  int quantise(int incoming_cv) {
+    if (tuning_is_loaded) return quantise_to_tuning(incoming_cv);
+    if (nothing_to_quantise) return incoming_cv;
+    int incoming_tone = map_mV_to_note_number(incoming_cv);
+    incoming_tone = transfer_value_to_range(incoming_tone, 0, QUANTISER_TABLE_SIZE - 1);
+    return map_note_number_to_mV(quantised_note_table[incoming_tone]);
+  }
+
+  void update_quantised_cv_table() {
+
+    // do not quantize if there are no notes selected
+    //  (this avoids an infinite while loop)
+    int number_of_active_notes = 0;
+    for (int i = 0; i < 12; i++) {
+      number_of_active_notes += scale[i];
+    }
+    nothing_to_quantise = (number_of_active_notes == 0);
+    if (nothing_to_quantise) return;
+
+    for (int i = 0; i < QUANTISER_TABLE_SIZE; i++) {
+      quantised_note_table[i] = find_nearest_note_in_scale(i, scale);
+    }
+  }
 
 public:
 
@@ -61,28 +165,43 @@ public:
 
   // Enable a note in the scale
   void enable_note(int note) {
-    if (note >= 0 && note < 12) {
+    if (note >= 0 && note < 12 && !scale[note]) {
       scale[note] = true;
+      update_quantised_cv_table();
     }
   }
 
   // Disable a note in the scale
   void disable_note(int note) {
-    if (note >= 0 && note < 12) {
+    if (note >= 0 && note < 12 && scale[note]) {
       scale[note] = false;
+      update_quantised_cv_table();
     }
+  }
 
-    // do not quantize if there are no notes selected
-    //  (this avoids an infinite while loop)
-    number_of_active_notes = 0;
-    for (int i = 0; i < 12; i++) {
-      number_of_active_notes += scale[i];
-      if (number_of_active_notes == 0) {
-        nothing_to_quantise = true;
-      } else {
-        nothing_to_quantise = false;
-      }
-    }
+  // Quantise to a tuning (saved in PROGMEM) instead of the 12-note scale
+  void load_tuning(const int* mV_array, const int* thresholds_mV_array, int degrees) {
+    if (degrees < 1) return;
+    tuning_mV = mV_array;
+    tuning_thresholds_mV = thresholds_mV_array;
+    number_of_degrees = degrees;
+    period_mV = max((int)pgm_read_word(tuning_mV + degrees), 1);
+    period_reciprocal = 65536UL / period_mV;
+    tuning_is_loaded = true;
+  }
+
+  void unload_tuning() {
+    tuning_is_loaded = false;
+  }
+
+  // Set how far (in mV) the CV must pass a threshold to change note
+  void set_hysteresis(int mV) {
+    hysteresis_mV = max(mV, 0);
+  }
+
+  // Set how long the note-change trigger stays high
+  void set_trigger_length(unsigned long duration) {
+    trigger_length = duration;
   }
 
   ///////////////////////////////////////////////////////////////////////////////
@@ -91,13 +210,28 @@ public:
 
   int run(int incoming_cv) {
 
-    if (nothing_to_quantise) {
-      quantised_cv = incoming_cv;
-    } else {
-      incoming_tone = map_mV_to_note_number(incoming_cv);
-      quantised_tone = find_nearest_note_in_scale(incoming_tone, scale);
-      quantised_cv = map_note_number_to_mV(quantised_tone);
+    int new_cv = quantise(incoming_cv);
+
+    // keep the current note unless the CV is past the threshold by the hysteresis
+    if (new_cv != quantised_cv && hysteresis_mV > 0) {
+      int pulled_back_cv = (new_cv > quantised_cv) ? incoming_cv - hysteresis_mV : incoming_cv + hysteresis_mV;
+      if (quantise(pulled_back_cv) == quantised_cv) new_cv = quantised_cv;
+    }
+
+    // trigger on a new note, not on every small change of a CV that is passed through
+    int new_note_mV = get_note_mV_of(new_cv);
+    if (new_note_mV != current_note_mV && hysteresis_mV > 0 && is_passing_through()) {
+      int pulled_back_cv = (new_note_mV > current_note_mV) ? incoming_cv - hysteresis_mV : incoming_cv + hysteresis_mV;
+      if (get_note_mV_of(pulled_back_cv) == current_note_mV) new_note_mV = current_note_mV;
+    }
+    note_changed = (new_note_mV != current_note_mV);
+    current_note_mV = new_note_mV;
+    if (note_changed) {
+      trigger_is_high = true;
+      reset_timer();
     }
+    quantised_cv = new_cv;
+    return quantised_cv;
   }
 
   ///////////////////////////////////////////////////////////////////////////////
@@ -108,4 +242,15 @@ public:
   int get_quantised_cv() {
     return quantised_cv;
   }
+
+  // Check if the last run() changed the note
+  bool has_note_changed() {
+    return note_changed;
+  }
+
+  // Check if the note-change trigger is high
+  bool get_trigger() {
+    if (trigger_is_high && get_timer() >= trigger_length) trigger_is_high = false;
+    return trigger_is_high;
+  }
 };
@@ -0,0 +1,83 @@
+/*
+Class Name: WavetableBank
+
+Purpose: Scan a continuous position across a bank of wavetables saved in flash.
+
+Dependencies: This class inherits from the Interpolate class.
+
+Use: Create an instance of the class and configure settings, then run:
+-- set_tables(table_array, table_length, number_of_tables): point the class to the tables (in PROGMEM)
+-- -- note: tables are saved back to back in one array, each table_length values long
+-- set_position(pct): scan across the bank from a pot (as a percent)
+-- -- or set_position_from_mV(mV, max_mV): scan across the bank from a CV (in mV)
+-- get_output_at(index): get the blended value at an index
+
+The two tables either side of the position are blended in fixed point, one value at
+a time, so each value costs the same however many tables there are and no table is
+copied into RAM. Use set_audio_source(&bank, table_length) to play the bank with Playback.
+*/
+
+class WavetableBank : public Interpolate {
+
+private:
+
+  const byte* tables;
+  int table_length = 0;
+  int number_of_tables = 0;
+
+  // position in tables (8.8 fixed point), where 0 is the first table
+  long current_position = -1;
+
+public:
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Getters and setters
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void set_tables(const byte* table_array, int length, int tables_in_bank) {
+    tables = table_array;
+    table_length = length;
+    number_of_tables = tables_in_bank;
+    current_position = -1;
+    enable_lazy_output();
+    set_position_fixed(0);
+  }
+
+  int get_number_of_tables() {
+    return number_of_tables;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Scan across the bank
+  ///////////////////////////////////////////////////////////////////////////////
+
+  // position is in 1/256ths of a table
+  void set_position_fixed(long position) {
+    long last_position = (long)(number_of_tables - 1) << 8;
+    if (position < 0) position = 0;
+    if (position > last_position) position = last_position;
+    if (position == current_position) return;
+    current_position = position;
+
+    // the last table has no neighbour above, so blend fully into it from below
+    int table = position >> 8;
+    unsigned int weight = position & 255;
+    if (table == number_of_tables - 1 && table > 0) {
+      table -= 1;
+      weight = 256;
+    }
+    int next_table = (table + 1 < number_of_tables) ? table + 1 : table;
+    set_inputs_from_flash(tables + (long)table * table_length, tables + (long)next_table * table_length, table_length);
+    interpolate_by_weight(weight);
+  }
+
+  void set_position(int pct) {
+    pct = transfer_value_to_range(pct, 0, 100);
+    set_position_fixed(((long)pct * (number_of_tables - 1) << 8) / 100);
+  }
+
+  void set_position_from_mV(int mV, int max_mV) {
+    mV = transfer_value_to_range(mV, 0, max_mV);
+    set_position_fixed(((long)mV * (number_of_tables - 1) << 8) / max_mV);
+  }
+};
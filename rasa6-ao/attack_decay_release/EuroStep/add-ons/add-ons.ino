@@ -1,11 +1,22 @@
 #include "C:/Users/61436/Dropbox/Hobbies/Electronics/GitHub/devkit/EuroStep/backend/power_funcs.h"
+#include "C:/Users/61436/Dropbox/Hobbies/Electronics/GitHub/devkit/EuroStep/backend/transfer_funcs.h"
+#include "C:/Users/61436/Dropbox/Hobbies/Electronics/GitHub/devkit/EuroStep/backend/fixed_funcs.h"
+#include "C:/Users/61436/Dropbox/Hobbies/Electronics/GitHub/devkit/EuroStep/backend/exp_funcs.h"
 #include "C:/Users/61436/Dropbox/Hobbies/Electronics/GitHub/devkit/EuroStep/backend/map_funcs.h"
 #include "C:/Users/61436/Dropbox/Hobbies/Electronics/GitHub/devkit/EuroStep/backend/Timer.h"
+#include "C:/Users/61436/Dropbox/Hobbies/Electronics/GitHub/devkit/EuroStep/backend/Adpcm.h"
+#include "C:/Users/61436/Dropbox/Hobbies/Electronics/GitHub/devkit/EuroStep/backend/Random.h"
 #include "Envelope.h"
+#include "Burst.h"
+#include "ClockDivider.h"
+#include "ClockMultiplier.h"
+#include "Euclid.h"
 #include "Interpolate.h"
 #include "Playback.h"
 #include "Predelay.h"
 #include "Quantiser.h"
+#include "RandomWalk.h"
+#include "WavetableBank.h"
 
 void setup() {
   // put your setup code here, to run once:
@@ -0,0 +1,140 @@
+/*
+Class Name: Adpcm
+
+Purpose: Decode 4-bit IMA-ADPCM audio (saved in flash) back into byte-wise values.
+
+Dependencies: Audio encoded by 'tools/adpcm_encode.py'.
+
+Use: Create an instance of the class and configure settings, then run:
+-- set_data(adpcm_array): point the class to the encoded array (in PROGMEM)
+-- get_value_at(index): decode forward to the index and return the value (0-255)
+
+You may wish to configure the following settings:
+-- set_loop_point(index): remember the decoder state at index so rewinds are cheap
+-- -- note: rewinding to any index before the loop point decodes again from the start
+-- -- note: the value at the loop point is kept, so reading it (e.g., to interpolate from the
+-- --       end of a loop back to its start) does not move the decoder
+
+Each value costs one decode, so playing forwards costs the same at every position.
+*/
+
+const int adpcm_step_table[89] PROGMEM = {
+  7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+  50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+  337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+  2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+  15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+const int8_t adpcm_index_table[8] PROGMEM = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+class Adpcm {
+
+private:
+
+  const byte* data;
+
+  // decoder state, where the predictor is the value scaled to 16 bits
+  int predictor = 0;
+  int step_index = 0;
+  int position = -1;  // index of current_value, -1 before anything is decoded
+  byte current_value = 128;
+  byte previous_value = 128;
+
+  // decoder state just before the loop point
+  int loop_predictor = 0;
+  int loop_step_index = 0;
+  int loop_position = -1;
+  byte loop_value = 128;
+  byte loop_start_value = 128;  // the value at the loop point itself
+
+  void rewind_to_start() {
+    predictor = 0;
+    step_index = 0;
+    position = -1;
+    current_value = 128;
+    previous_value = 128;
+  }
+
+  void rewind_to_loop_point() {
+    predictor = loop_predictor;
+    step_index = loop_step_index;
+    position = loop_position;
+    current_value = loop_value;
+    previous_value = loop_value;
+  }
+
+  void decode_next() {
+
+    // each byte holds two codes, low nibble first
+    position += 1;
+    byte code = pgm_read_byte(data + (position >> 1));
+    if (position & 1) code = code >> 4;
+    code = code & 15;
+
+    // rebuild the difference from the step size, as per the IMA standard
+    long step = pgm_read_word(adpcm_step_table + step_index);
+    long difference = step >> 3;
+    if (code & 4) difference += step;
+    if (code & 2) difference += step >> 1;
+    if (code & 1) difference += step >> 2;
+    long new_predictor = (code & 8) ? predictor - difference : predictor + difference;
+    if (new_predictor < -32768L) new_predictor = -32768L;
+    if (new_predictor > 32767L) new_predictor = 32767L;
+    predictor = new_predictor;
+
+    // adapt the step size for the next code
+    step_index += (int8_t)pgm_read_byte(adpcm_index_table + (code & 7));
+    step_index = transfer_value_to_range(step_index, 0, 88);
+
+    previous_value = current_value;
+    current_value = (predictor >> 8) + 128;
+  }
+
+public:
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Getters and setters
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void set_data(const byte* adpcm_array) {
+    data = adpcm_array;
+    rewind_to_start();
+    set_loop_point(0);
+  }
+
+  void set_loop_point(int index) {
+    if (index <= position) {
+      if (index > loop_position) {
+        rewind_to_loop_point();  // e.g., the same loop point again
+      } else {
+        rewind_to_start();
+      }
+    }
+    while (position < index - 1) decode_next();
+    loop_predictor = predictor;
+    loop_step_index = step_index;
+    loop_position = position;
+    loop_value = current_value;
+    decode_next();
+    loop_start_value = current_value;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Do the work
+  ///////////////////////////////////////////////////////////////////////////////
+
+  byte get_value_at(int index) {
+    if (index == position - 1) return previous_value;  // e.g., fractional steps can repeat an index
+    if (index == loop_position + 1) return loop_start_value;  // e.g., interpolating across the loop
+    if (index < position) {
+      if (index > loop_position) {
+        rewind_to_loop_point();
+      } else {
+        rewind_to_start();
+      }
+    }
+    while (position < index) decode_next();
+    return current_value;
+  }
+};
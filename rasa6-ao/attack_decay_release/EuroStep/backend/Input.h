@@ -16,6 +16,10 @@ You can customise settings further via:
 -- set_max_input_mV(int value): Sets the maximum expected input voltage in millivolts.
 -- set_reverse_input(bool value): Enables or disables reversing of the input value.
 -- set_debug(bool value): Enables or disables debug mode for additional logging.
+-- set_mV_per_reading(long value_Q16): Converts each analogRead() step to mV in integer math.
+-- -- note: e.g., jack_mV_per_reading_Q16 from 'flash_tables.h' (default: 0, which uses float math)
+-- set_percent_curve(const byte* curve): Reads the percent from a table in PROGMEM.
+-- -- note: the table has 256 entries, one for each analogRead() / 4 (e.g., PotPercentCurve)
 
 You actually get the input value via:
 -- get_input_as_mV(): Returns the current input value in millivolts (mV).
@@ -53,6 +57,11 @@ private:
   int r1_value;
   int r2_value;
 
+  // used to convert readings without float math
+  long mV_per_reading_Q16 = 0;
+  int current_reading = 0;
+  const byte* percent_curve = nullptr;
+
   // used to smooth input using moving average (i.e., for "jacks")
   bool smooth_input = false;
 
@@ -71,6 +80,10 @@ private:
     last_value_mV = current_value_mV;  // save last value -- used for clock signals
     if (input_is_digital) {
       current_value_mV = max_input_mV * digitalRead(input_pin);  // convert digital to mV to unify getters()
+    } else if (mV_per_reading_Q16 > 0) {
+      current_reading = read_analog_reading(input_pin);
+      current_value_mV = ((long)current_reading * mV_per_reading_Q16) >> 16;
+      if (smooth_input) current_value_mV = smooth_mV(current_value_mV, current_value_mV_history);
     } else {
       if (smooth_input) {
         current_value_mV = read_analog_mV_smooth(input_pin, current_value_mV_history, r1_value, r2_value, debug);
@@ -140,6 +153,14 @@ public:
     reverse_input = value;
   }
 
+  void set_mV_per_reading(long value_Q16) {
+    mV_per_reading_Q16 = value_Q16;
+  }
+
+  void set_percent_curve(const byte* curve) {
+    percent_curve = curve;
+  }
+
   void set_debug(bool value) {
     debug = value;
   }
@@ -155,7 +176,11 @@ public:
 
   int get_input_as_percent() {
     read_input_if_ready();
-    current_value_percent = map_mV_to_percent(current_value_mV, max_input_mV);
+    if (percent_curve != nullptr && mV_per_reading_Q16 > 0) {
+      current_value_percent = pgm_read_byte(percent_curve + (current_reading >> 2));
+    } else {
+      current_value_percent = map_mV_to_percent(current_value_mV, max_input_mV);
+    }
     return round_to_nearest(current_value_percent, round_percent_to);
   }
 
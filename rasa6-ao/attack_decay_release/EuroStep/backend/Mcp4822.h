@@ -12,6 +12,9 @@ Use: Create an instance of the class and then configure the settings:
 You actually write to the DAC via:
 -- send_to_channel_A(int mV_out): Sends a specified voltage (mV) to channel A of the DAC.
 -- send_to_channel_B(int mV_out): Sends a specified voltage (mV) to channel B of the DAC.
+
+For a DAC that the board may not have, use Mcp4822IfPresent<present>::type, which is an
+empty NoMcp4822 (where every call compiles to nothing) when 'present' is false.
 */
 
 class Mcp4822 {
@@ -30,8 +33,8 @@ private:
   bool dac_code[16] = { 0 };
   int gain = 1;
 
-  // keep history
-  int last_mV_out = 0;
+  // keep history, so a channel is only written when its value changes
+  int last_mV_out[2] = { -1, -1 };
 
   ///////////////////////////////////////////////////////////////////////////////
   /// Interpret Chip Register
@@ -153,10 +156,10 @@ private:
     if (pin_cs > -1) {  // pin_cs = -1 used to skip whole thing
       if (mV_out < 0) mV_out = 0;
       if (mV_out > 4095) mV_out = 4095;  // chip cannot write 4096!!
-      if (mV_out != last_mV_out) {
+      if (mV_out != last_mV_out[use_channel_B]) {
         update_dac_code(mV_out, use_channel_B);
         write_dac_code();
-        last_mV_out = mV_out;
+        last_mV_out[use_channel_B] = mV_out;
       }
     }
   }
@@ -190,3 +193,24 @@ public:
     send_to_dac(mV_out, 1);
   };
 };
+
+// stands in for a DAC that is not fitted, so the same calls cost no flash, RAM or time
+class NoMcp4822 {
+
+public:
+
+  void set_pins(int, int, int, int) {}
+  void set_debug(bool) {}
+  void send_to_channel_A(int) {}
+  void send_to_channel_B(int) {}
+};
+
+template<bool present>
+struct Mcp4822IfPresent {
+  typedef Mcp4822 type;
+};
+
+template<>
+struct Mcp4822IfPresent<false> {
+  typedef NoMcp4822 type;
+};
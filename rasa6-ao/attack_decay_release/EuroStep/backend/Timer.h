@@ -8,6 +8,7 @@ Dependencies: None.
 Use: Create an instance of the class and configure settings, then run:
 -- get_timer(): returns how much time has passed since reset_timer() was called
 -- reset_timer(): resets the timer to 0
+-- advance_timer(value): moves the start of the timer forward by value (keeps any overshoot)
 
 You may wish to configure the following settings:
 -- use_millis(): use milliseconds for the timer (default)
@@ -55,4 +56,9 @@ public:
   void reset_timer() {
     last_timer = time_right_now();
   }
+
+  // unlike reset_timer(), time already past 'value' is carried into the next count
+  void advance_timer(unsigned long value) {
+    last_timer += value;
+  }
 };
@@ -1,11 +1,16 @@
 #include "power_funcs.h"
 #include "transfer_funcs.h"
 #include "bit_funcs.h"
+#include "fixed_funcs.h"
+#include "exp_funcs.h"
 #include "map_funcs.h"
+#include "flash_tables.h"
 #include "read_funcs.h"
 #include "Timer.h"
 #include "Input.h"
 #include "Mcp4822.h"
+#include "Adpcm.h"
+#include "Random.h"
 
 void setup() {
   // put your setup code here, to run once:
@@ -0,0 +1,156 @@
+/**
+ * 2^(i/64) for one octave (i = 0 to 64), in Q14 fixed point (16384 = 1.0).
+ *
+ * Any power of 2 is found from this one octave plus a shift, and linear
+ * interpolation between entries keeps the error below 0.2 cents.
+ */
+const uint16_t exp2_table[65] PROGMEM = {
+  16384, 16562, 16743, 16925, 17109, 17296, 17484, 17674, 17867, 18061, 18258, 18457, 18658,
+  18861, 19066, 19274, 19484, 19696, 19911, 20127, 20347, 20568, 20792, 21019, 21247, 21479,
+  21713, 21949, 22188, 22430, 22674, 22921, 23170, 23423, 23678, 23936, 24196, 24460, 24726,
+  24995, 25268, 25543, 25821, 26102, 26386, 26674, 26964, 27258, 27554, 27855, 28158, 28464,
+  28774, 29088, 29405, 29725, 30048, 30376, 30706, 31041, 31379, 31720, 32066, 32415, 32768
+};
+
+/**
+ * Computes 2^x for a fraction of an octave.
+ *
+ * @param fraction The fraction of an octave in Q16 fixed point (0 to 65535).
+ * @return 2^(fraction / 65536) in Q14 fixed point (16384 to 32767).
+ */
+unsigned int exp2_fraction(unsigned int fraction) {
+  byte index = fraction >> 10;              // top 6 bits pick the table entry
+  unsigned int position = fraction & 1023;  // bottom 10 bits interpolate to the next one
+  unsigned int low = pgm_read_word(exp2_table + index);
+  unsigned int high = pgm_read_word(exp2_table + index + 1);
+  return low + (((unsigned long)(high - low) * position) >> 10);
+}
+
+/**
+ * Converts a 1V/oct voltage (mV) to octaves in Q16 fixed point.
+ *
+ * To avoid float math, mV / 1000 * 65536 is done as mV * 67109 / 2^10.
+ *
+ * @param mV The voltage in millivolts (1000 mV per octave).
+ * @return The number of octaves in Q16 fixed point (65536 = 1 octave).
+ */
+long map_mV_to_octaves(int mV) {
+  return ((long)mV * 67109) >> 10;
+}
+
+/**
+ * Multiplies a value by 2^x in integer math.
+ *
+ * The octaves are split into a whole number (a shift) and a fraction (a table lookup),
+ * so this is one lookup, two multiplies and a shift. The result saturates instead of
+ * overflowing.
+ *
+ * @param value The value to scale (e.g., a frequency, a timer period or a phase increment).
+ * @param octaves The power of 2 in Q16 fixed point (65536 = 1 octave, may be negative).
+ * @return value * 2^(octaves / 65536).
+ */
+unsigned long scale_by_exp2(unsigned long value, long octaves) {
+  int whole_octaves = octaves >> 16;  // rounds down, also for negative octaves
+  unsigned int multiplier = exp2_fraction(octaves & 0xFFFF);
+
+  // value * multiplier / 2^14, split so that nothing overflows 32 bits
+  if (value & 0x80000000UL) {
+    value = value >> 1;
+    whole_octaves += 1;
+  }
+  unsigned long scaled = (value >> 14) * multiplier + (((value & 16383) * multiplier + 8192) >> 14);
+
+  if (whole_octaves >= 0) {
+    if (whole_octaves > 31 || scaled > (0xFFFFFFFFUL >> whole_octaves)) return 0xFFFFFFFFUL;
+    return scaled << whole_octaves;
+  }
+  if (whole_octaves < -31) return 0;
+  return (scaled + (1UL << (-whole_octaves - 1))) >> -whole_octaves;
+}
+
+/**
+ * Maps a 1V/oct voltage (mV) to a frequency in milli-Hertz, in integer math.
+ *
+ * @param mV The voltage in millivolts (1000 mV per octave).
+ * @param milliHz_at_zero_volts The frequency at 0V, in milli-Hertz (e.g., 440000 for 440 Hz).
+ * @return The frequency in milli-Hertz.
+ */
+unsigned long map_mV_to_milliHz(int mV, unsigned long milliHz_at_zero_volts) {
+  return scale_by_exp2(milliHz_at_zero_volts, map_mV_to_octaves(mV));
+}
+
+/**
+ * Maps a 1V/oct voltage (mV) to a period in microseconds, in integer math.
+ *
+ * This gives a timer period directly, without dividing by the frequency.
+ *
+ * @param mV The voltage in millivolts (1000 mV per octave).
+ * @param micros_at_zero_volts The period at 0V, in microseconds.
+ * @return The period in microseconds.
+ */
+unsigned long map_mV_to_period_micros(int mV, unsigned long micros_at_zero_volts) {
+  return scale_by_exp2(micros_at_zero_volts, -map_mV_to_octaves(mV));
+}
+
+/**
+ * Computes 2^x as a float, without calling exp() or log().
+ *
+ * @param octaves The power of 2 in Q16 fixed point (65536 = 1 octave, may be negative).
+ * @return 2^(octaves / 65536).
+ */
+float exp2_float(long octaves) {
+  int whole_octaves = octaves >> 16;
+  return ldexp(exp2_fraction(octaves & 0xFFFF), whole_octaves - 14);
+}
+
+/**
+ * log2(1 + i/64) for i = 0 to 64, in Q15 fixed point (32768 = 1.0).
+ */
+const uint16_t log2_table[65] PROGMEM = {
+  0, 733, 1455, 2166, 2866, 3556, 4236, 4907, 5568, 6220, 6863, 7498, 8124,
+  8742, 9352, 9954, 10549, 11136, 11716, 12289, 12855, 13415, 13968, 14514, 15055, 15589,
+  16117, 16639, 17156, 17667, 18173, 18673, 19168, 19658, 20143, 20623, 21098, 21568, 22034,
+  22495, 22952, 23404, 23852, 24296, 24736, 25172, 25604, 26031, 26455, 26876, 27292, 27705,
+  28114, 28520, 28922, 29321, 29717, 30109, 30498, 30884, 31267, 31647, 32024, 32397, 32768
+};
+
+/**
+ * Computes log2(x) in integer math.
+ *
+ * The whole octaves come from the position of the highest bit, and the rest
+ * from the table above with linear interpolation.
+ *
+ * @param value A positive Q16 value (65536 = 1.0).
+ * @return log2(value / 65536) in Q16 fixed point (very negative for 0).
+ */
+long log2_Q16(unsigned long value) {
+  if (value == 0) return -2147483647L;
+  int whole_octaves = -1;  // 0x8000 to 0xFFFF is 0.5 to just under 1.0
+  while (value >= 0x10000UL) {
+    value = value >> 1;
+    whole_octaves += 1;
+  }
+  while (value < 0x8000UL) {
+    value = value << 1;
+    whole_octaves -= 1;
+  }
+  unsigned int fraction = value - 0x8000U;  // 15 bits between one octave and the next
+  byte index = fraction >> 9;
+  unsigned int position = fraction & 511;
+  unsigned int low = pgm_read_word(log2_table + index);
+  unsigned int high = pgm_read_word(log2_table + index + 1);
+  unsigned int log_fraction = low + (((unsigned long)(high - low) * position) >> 9);
+  return ((long)whole_octaves << 16) + ((long)log_fraction << 1);
+}
+
+/**
+ * Computes a^b in integer math, as 2^(b * log2(a)).
+ *
+ * @param a The base, as a positive Q16 value.
+ * @param b The exponent, as a Q16 value (may be negative).
+ * @return a^b as a Q16 value (saturates instead of overflowing).
+ */
+unsigned long power_Q16(unsigned long a, long b) {
+  if (a == 0) return 0;
+  return scale_by_exp2(65536UL, multiply_Q16(b, log2_Q16(a)));
+}
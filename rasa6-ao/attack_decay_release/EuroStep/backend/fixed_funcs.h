@@ -0,0 +1,148 @@
+/**
+ * Fixed-point helpers, used instead of float math in code that runs every step.
+ *
+ * Q15 values are ints where 32767 is just under 1.0 (and -32768 is -1.0).
+ * Q16 values are longs where 65536 is 1.0.
+ */
+
+/**
+ * Clamps a long to the range of an int.
+ *
+ * @param value The value to clamp.
+ * @return The value, limited to -32768 to 32767.
+ */
+int saturate_to_int(long value) {
+  if (value > 32767L) return 32767;
+  if (value < -32768L) return -32768;
+  return value;
+}
+
+/**
+ * Adds two Q15 values, saturating instead of overflowing.
+ *
+ * @param a The first Q15 value.
+ * @param b The second Q15 value.
+ * @return a + b, limited to the Q15 range.
+ */
+int add_Q15(int a, int b) {
+  return saturate_to_int((long)a + b);
+}
+
+/**
+ * Multiplies two Q15 values, with rounding.
+ *
+ * @param a The first Q15 value.
+ * @param b The second Q15 value.
+ * @return a * b in Q15 (-1.0 * -1.0 saturates to just under 1.0).
+ */
+int multiply_Q15(int a, int b) {
+  return saturate_to_int(((long)a * b + 16384) >> 15);
+}
+
+/**
+ * Interpolates between two values by a Q15 fraction.
+ *
+ * @param a The value when t is 0.
+ * @param b The value when t is 32767 (just short of 1.0).
+ * @param t How far to move from a to b, in Q15 (0 to 32767).
+ * @return a + (b - a) * t.
+ */
+int lerp_Q15(int a, int b, int t) {
+  return a + ((((long)b - a) * t) >> 15);
+}
+
+/**
+ * Adds two Q16 values, saturating instead of overflowing.
+ *
+ * @param a The first Q16 value.
+ * @param b The second Q16 value.
+ * @return a + b, limited to the range of a long.
+ */
+long add_Q16(long a, long b) {
+  if (b > 0 && a > 2147483647L - b) return 2147483647L;
+  if (b < 0 && a < -2147483647L - 1 - b) return -2147483647L - 1;
+  return a + b;
+}
+
+/**
+ * Multiplies two Q16 values, with rounding.
+ *
+ * @param a The first Q16 value.
+ * @param b The second Q16 value.
+ * @return a * b in Q16, limited to the range of a long.
+ */
+long multiply_Q16(long a, long b) {
+  int64_t product = ((int64_t)a * b + 32768) >> 16;
+  if (product > 2147483647L) return 2147483647L;
+  if (product < -2147483647L - 1) return -2147483647L - 1;
+  return product;
+}
+
+/**
+ * Interpolates between two longs by a Q16 fraction.
+ *
+ * @param a The value when t is 0.
+ * @param b The value when t is 65535 (just short of 1.0).
+ * @param t How far to move from a to b, in Q16 (0 to 65535).
+ * @return a + (b - a) * t.
+ */
+long lerp_Q16(long a, long b, unsigned int t) {
+  return a + ((((int64_t)b - a) * t) >> 16);
+}
+
+/**
+ * Scales a value by a percentage, without dividing by 100.
+ *
+ * The percentage is turned into a Q16 fraction (pct * 655.36 as pct * 41943 / 2^6),
+ * so the value is scaled by one multiply and one shift, with rounding.
+ *
+ * @param value The value to scale.
+ * @param pct The percentage (0 to 100).
+ * @return value * pct / 100, rounded to the nearest integer.
+ */
+int scale_by_percent(int value, int pct) {
+  if (pct < 0) pct = 0;
+  if (pct > 100) pct = 100;
+  long fraction = ((long)pct * 41943 + 32) >> 6;  // Q16, 65536 at 100%
+  return ((long)value * fraction + 32768) >> 16;
+}
+
+/**
+ * 2^16 / n for n = 1 to 255 (2^16 - 1 for n = 1), used to divide by multiplying.
+ */
+const uint16_t reciprocal_table[255] PROGMEM = {
+  65535, 32768, 21845, 16384, 13107, 10922, 9362, 8192, 7281, 6553, 5957, 5461, 5041, 4681, 4369,
+  4096, 3855, 3640, 3449, 3276, 3120, 2978, 2849, 2730, 2621, 2520, 2427, 2340, 2259, 2184,
+  2114, 2048, 1985, 1927, 1872, 1820, 1771, 1724, 1680, 1638, 1598, 1560, 1524, 1489, 1456,
+  1424, 1394, 1365, 1337, 1310, 1285, 1260, 1236, 1213, 1191, 1170, 1149, 1129, 1110, 1092,
+  1074, 1057, 1040, 1024, 1008, 992, 978, 963, 949, 936, 923, 910, 897, 885, 873,
+  862, 851, 840, 829, 819, 809, 799, 789, 780, 771, 762, 753, 744, 736, 728,
+  720, 712, 704, 697, 689, 682, 675, 668, 661, 655, 648, 642, 636, 630, 624,
+  618, 612, 606, 601, 595, 590, 585, 579, 574, 569, 564, 560, 555, 550, 546,
+  541, 537, 532, 528, 524, 520, 516, 512, 508, 504, 500, 496, 492, 489, 485,
+  481, 478, 474, 471, 468, 464, 461, 458, 455, 451, 448, 445, 442, 439, 436,
+  434, 431, 428, 425, 422, 420, 417, 414, 412, 409, 407, 404, 402, 399, 397,
+  394, 392, 390, 387, 385, 383, 381, 378, 376, 374, 372, 370, 368, 366, 364,
+  362, 360, 358, 356, 354, 352, 350, 348, 346, 344, 343, 341, 339, 337, 336,
+  334, 332, 330, 329, 327, 326, 324, 322, 321, 319, 318, 316, 315, 313, 312,
+  310, 309, 307, 306, 304, 303, 302, 300, 299, 297, 296, 295, 293, 292, 291,
+  289, 288, 287, 286, 284, 283, 282, 281, 280, 278, 277, 276, 275, 274, 273,
+  271, 270, 269, 268, 267, 266, 265, 264, 263, 262, 261, 260, 259, 258, 257
+};
+
+/**
+ * Divides by a small number using the reciprocal table, instead of a division.
+ *
+ * The reciprocal is rounded down, so the first guess can be one too small;
+ * a single check of the remainder makes the result exact.
+ *
+ * @param value The value to divide (0 to 65535).
+ * @param divisor The number to divide by (1 to 255).
+ * @return value / divisor, rounded down (exactly as integer division).
+ */
+unsigned int divide_by_byte(unsigned int value, byte divisor) {
+  unsigned int reciprocal = pgm_read_word(reciprocal_table + divisor - 1);
+  unsigned int quotient = ((unsigned long)value * reciprocal) >> 16;
+  if (value - quotient * divisor >= divisor) quotient += 1;
+  return quotient;
+}
@@ -0,0 +1,151 @@
+/*
+Purpose: Build lookup tables at compile time and keep them in flash (PROGMEM).
+
+Dependencies: The hardware macros (e.g., V_DIVIDER_R1, MAX_POT_VOLTAGE) for the hardware tables.
+
+Use: Write a generator (a struct with a constexpr function 'value(i)' and a 'value_type'),
+then read the table from flash:
+-- FlashTable<Generator, length>::values: the table, in PROGMEM
+-- -- note: give the table a name first, as pgm_read_word() is a macro and cannot take the comma
+-- -- e.g., typedef FlashTable<NoteToMillivolts, 128> NoteTable;
+-- --       pgm_read_word(NoteTable::values + note)
+
+Tables are only placed in flash if they are used, they cost nothing at start up,
+and they are rebuilt automatically when the hardware macros change.
+
+The following generators are ready to use:
+-- PotPercentCurveOf<max_mV, reverse>: analogRead() / 4 to percent (e.g., for a board type)
+-- PotPercentCurve: the same, from MAX_POT_VOLTAGE and REVERSE_POT
+-- NoteToMillivolts: note number to mV (the same as map_note_number_to_mV())
+-- Exp2Curve<start, octaves_x100, length>: 'start' rising exponentially by a number of octaves
+
+These constants are also worked out from the hardware macros:
+-- pot_mV_per_reading_Q16: mV per analogRead() step for pots
+-- jack_mV_per_reading_Q16: mV per analogRead() step for jacks, including the voltage divider
+-- -- note: or get_jack_mV_per_reading_Q16(r1, r2) for any divider
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+/// Make a list of indices (0, 1, ..., N - 1) to expand into a table
+///////////////////////////////////////////////////////////////////////////////
+
+template<int... I>
+struct index_list {};
+
+// joins two lists, where the second continues on from the first
+template<class First, class Second>
+struct join_index_lists;
+
+template<int... I, int... J>
+struct join_index_lists<index_list<I...>, index_list<J...>> {
+  typedef index_list<I..., (sizeof...(I) + J)...> type;
+};
+
+// halving the list each time keeps the template depth small, even for long tables
+template<int N>
+struct make_index_list {
+  typedef typename join_index_lists<typename make_index_list<N / 2>::type, typename make_index_list<N - N / 2>::type>::type type;
+};
+
+template<>
+struct make_index_list<0> {
+  typedef index_list<> type;
+};
+
+template<>
+struct make_index_list<1> {
+  typedef index_list<0> type;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Expand a generator into a table in flash
+///////////////////////////////////////////////////////////////////////////////
+
+template<class Generator, class Indices>
+struct FlashTableOf;
+
+template<class Generator, int... I>
+struct FlashTableOf<Generator, index_list<I...>> {
+  static const typename Generator::value_type values[sizeof...(I)];
+};
+
+template<class Generator, int... I>
+const typename Generator::value_type FlashTableOf<Generator, index_list<I...>>::values[sizeof...(I)] PROGMEM = { Generator::value(I)... };
+
+template<class Generator, int length>
+struct FlashTable : FlashTableOf<Generator, typename make_index_list<length>::type> {};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Compile-time math (C++11 constexpr functions are a single return)
+///////////////////////////////////////////////////////////////////////////////
+
+constexpr long constexpr_round(double value) {
+  return value < 0 ? -(long)(0.5 - value) : (long)(value + 0.5);
+}
+
+constexpr long constexpr_clamp(long value, long min, long max) {
+  return value < min ? min : (value > max ? max : value);
+}
+
+// e^x as a Taylor series, which converges quickly for 0 <= x < ln(2)
+constexpr double constexpr_exp_series(double x, int n, double term, double sum) {
+  return n > 16 ? sum : constexpr_exp_series(x, n + 1, term * x / n, sum + term * x / n);
+}
+
+// 2^x, one whole octave at a time and then the series for the fraction
+constexpr double constexpr_exp2(double x) {
+  return x < 0 ? 1.0 / constexpr_exp2(-x) : (x >= 1 ? 2.0 * constexpr_exp2(x - 1) : constexpr_exp_series(x * 0.69314718056, 1, 1.0, 1.0));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Generators
+///////////////////////////////////////////////////////////////////////////////
+
+// note number to mV, truncated like map_note_number_to_mV()
+struct NoteToMillivolts {
+  typedef uint16_t value_type;
+  static constexpr value_type value(int note_number) {
+    return (long)note_number * 833333L / 10000L;
+  }
+};
+
+// 'start' rising by octaves_x100 / 100 octaves over the table (e.g., for exponential rates)
+template<unsigned long start, int octaves_x100, int length>
+struct Exp2Curve {
+  typedef uint16_t value_type;
+  static constexpr value_type value(int i) {
+    return constexpr_clamp(constexpr_round(start * constexpr_exp2(octaves_x100 / 100.0 * i / (length - 1))), 0, 65535);
+  }
+};
+
+// analogRead() reads 4.9 mV per step (10-bit, 5V reference)
+constexpr long pot_mV_per_reading_Q16 = constexpr_round(4.9 * 65536);
+
+// analogRead() / 4 to percent, with the same clamp and reverse as Input
+template<long max_mV, bool reverse>
+struct PotPercentCurveOf {
+  typedef byte value_type;
+  static constexpr long mV(int i) {
+    return constexpr_clamp(((4L * i + 2) * 49) / 10, 0, max_mV);
+  }
+  static constexpr value_type value(int i) {
+    return (reverse ? max_mV - mV(i) : mV(i)) / (max_mV / 100);
+  }
+};
+
+// undo the voltage divider in front of the jacks
+constexpr long get_jack_mV_per_reading_Q16(long r1, long r2) {
+  return constexpr_round(4.9 * 65536 * (r1 + r2) / r2);
+}
+
+#if defined(MAX_POT_VOLTAGE) && defined(REVERSE_POT)
+
+typedef PotPercentCurveOf<MAX_POT_VOLTAGE, REVERSE_POT> PotPercentCurve;
+
+#endif
+
+#if defined(V_DIVIDER_R1) && defined(V_DIVIDER_R2)
+
+constexpr long jack_mV_per_reading_Q16 = get_jack_mV_per_reading_Q16(V_DIVIDER_R1, V_DIVIDER_R2);
+
+#endif
@@ -5,12 +5,13 @@
  * @param min The minimum integer value of the desired range.
  * @param max The maximum integer value of the desired range.
  * @return An integer between min and max, based on the percentage input.
+ *
+ * This is done in integer math, rounding towards min.
  */
 int map_percent_to_range(int pct, int min, int max) {
   if (pct < 0) pct = 0;
   if (pct > 100) pct = 100;
-  double scale = static_cast<double>(pct) / 100.0;                 // Normalize byte_value to [0, 1]
-  int mapped_value = min + static_cast<int>(scale * (max - min));  // Scale to [min, max]
+  int mapped_value = min + (long)pct * ((long)max - min) / 100;  // Scale to [min, max]
   return mapped_value;
 }
 
@@ -22,13 +23,31 @@ int map_percent_to_range(int pct, int min, int max) {
  * @param max The maximum integer value of the desired range.
  * @return An integer value mapped to the range [min, max], based on the normalized
  *         value of byte_value.
+ *
+ * This is done in integer math, rounding towards min.
  */
 int map_byte_to_range(byte byte_value, int min, int max) {
-  double scale = static_cast<double>(byte_value) / 255.0;          // Normalize byte_value to [0, 1]
-  int mapped_value = min + static_cast<int>(scale * (max - min));  // Scale to [min, max]
+  int mapped_value = min + (long)byte_value * ((long)max - min) / 255;  // Scale to [min, max]
   return mapped_value;
 }
 
+/**
+ * Maps a percentage value to a Q16 fixed-point value within a centered range [-plus_or_minus, plus_or_minus].
+ *
+ * This is the integer version of map_percent_to_centred_range(), where 65536 is 1.0.
+ *
+ * @param pct An integer representing the percentage (expected range: 0 to 100).
+ * @param plus_or_minus The maximum absolute value of the mapped range.
+ * @return A Q16 value within the range [-plus_or_minus, plus_or_minus].
+ */
+long map_percent_to_centred_range_Q16(int pct, int plus_or_minus) {
+  if (pct < 0) pct = 0;
+  if (pct > 100) pct = 100;
+  long scaled = (long)(pct - 50) * plus_or_minus;  // at most 50 * 32768, so this fits
+  long new_val = scaled / 50 * 65536L + scaled % 50 * 65536L / 50;  // divide first, keeping the remainder
+  return (new_val);
+}
+
 /**
  * Maps a percentage value to a float within a centered range [-plus_or_minus, plus_or_minus].
  *
@@ -45,14 +64,7 @@ int map_byte_to_range(byte byte_value, int min, int max) {
  *         from the given percentage.
  */
 float map_percent_to_centred_range(int pct, int plus_or_minus) {
-  if (pct < 0) pct = 0;
-  if (pct > 100) pct = 100;
-  float new_val = (pct - 50) / (50.0 / plus_or_minus);
-  if (new_val < 0) {
-    new_val = max(new_val, -1 * plus_or_minus);
-  } else {
-    new_val = min(new_val, plus_or_minus);
-  }
+  float new_val = map_percent_to_centred_range_Q16(pct, plus_or_minus) / 65536.0;
   return (new_val);
 }
 
@@ -66,6 +78,9 @@ float map_percent_to_centred_range(int pct, int plus_or_minus) {
  * centered at `exp_mid`, and finally converted into a float using a power 
  * of 2 calculation.
  *
+ * The exponent is kept in Q16 fixed point and 2^x comes from the table in exp_funcs.h,
+ * so no exp() or log() is called.
+ *
  * @param pct An integer representing the percentage (expected range: 0 to 100).
  * @param exp_mid The central exponent value around which the exponential range is centered.
  * @param plus_or_minus The maximum absolute offset for the exponent from `exp_mid`. 
@@ -76,9 +91,24 @@ float map_percent_to_centred_range(int pct, int plus_or_minus) {
 float map_percent_to_centred_exp_range(int pct, int exp_mid, int plus_or_minus) {
   if (pct < 0) pct = 0;
   if (pct > 100) pct = 100;
-  float exp_offset = map_percent_to_centred_range(pct, plus_or_minus);
-  float exp = exp_mid + exp_offset;
-  float new_val = power_float(2, exp);
+  long exp = (long)exp_mid * 65536L + map_percent_to_centred_range_Q16(pct, plus_or_minus);
+  float new_val = exp2_float(exp);
+  return (new_val);
+}
+
+/**
+ * Maps a percentage value to a Q16 fixed-point value within an exponential range.
+ *
+ * This is the integer version of map_percent_to_centred_exp_range(), where 65536 is 1.0.
+ *
+ * @param pct An integer representing the percentage (expected range: 0 to 100).
+ * @param exp_mid The central exponent value around which the exponential range is centered.
+ * @param plus_or_minus The maximum absolute offset for the exponent from `exp_mid`.
+ * @return 2^exp as a Q16 value (saturates when exp is 16 or more).
+ */
+unsigned long map_percent_to_centred_exp_range_Q16(int pct, int exp_mid, int plus_or_minus) {
+  long exp = (long)exp_mid * 65536L + map_percent_to_centred_range_Q16(pct, plus_or_minus);
+  unsigned long new_val = scale_by_exp2(65536UL, exp);
   return (new_val);
 }
 
@@ -92,9 +122,15 @@ float map_percent_to_centred_exp_range(int pct, int exp_mid, int plus_or_minus)
  * @param mV The millivolt value to be converted to a percentage.
  * @param max_mV The maximum millivolt value to which the mV is compared. Default is 5000 mV.
  * @return The percentage of mV relative to max_mV (0 to 100).
+ *
+ * When max_mV / 100 fits in a byte, the division is done with divide_by_byte().
  */
 int map_mV_to_percent(int mV, int max_mV) {
-  int pct = mV / (max_mV / 100);
+  int mV_per_percent = max_mV / 100;
+  if (mV >= 0 && mV_per_percent > 0 && mV_per_percent < 256) {
+    return divide_by_byte(mV, mV_per_percent);
+  }
+  int pct = mV / mV_per_percent;
   return (pct);
 }
 
@@ -104,14 +140,16 @@ int map_mV_to_percent(int mV, int max_mV) {
  * This function calculates the frequency in Hertz (Hz) corresponding to a given millivolt value (mV),
  * using a reference frequency (`Hz_at_zero_volts`) that represents the frequency when the voltage is 0V.
  * The relationship assumes the frequency follows a logarithmic scale relative to the voltage.
+ *
+ * This is done in integer math by map_mV_to_milliHz() (see exp_funcs.h), which is
+ * accurate to within a quarter of a cent. Use it directly to avoid the float result.
  * 
  * @param mV The millivolt value that affects the frequency.
  * @param Hz_at_zero_volts The reference frequency in Hertz at 0V, used to determine the frequency at other voltages.
  * @return The resulting frequency in Hertz, calculated based on the provided mV value and reference frequency.
  */
 float map_mV_to_Hz(int mV, int Hz_at_zero_volts) {
-  int reference_voltage = log(Hz_at_zero_volts) / log(2) * 1000;
-  float Hz = power_float(2, (reference_voltage + mV) / 1000.0);
+  float Hz = map_mV_to_milliHz(mV, Hz_at_zero_volts * 1000UL) / 1000.0;
   return (Hz);
 }
 
@@ -139,13 +177,14 @@ int map_Hz_to_micros(int Hz) {
  * of 83.3333 mV corresponds to a change of one note. The resulting note number 
  * is rounded to the nearest integer.
  *
+ * To avoid float math, mV / 83.3333 is done as mV * 50332 / 2^22 (within 0.001% of 12 / 1000).
+ *
  * @param mV The input voltage in millivolts.
  * @return An integer representing the rounded musical note number.
  */
 int map_mV_to_note_number(int mV) {
 
-  float note_to_round = mV / 83.3333f;
-  int note_number = round(note_to_round);
+  int note_number = ((long)mV * 50332 + 2097152) >> 22;
   return note_number;
 }
 
@@ -156,11 +195,15 @@ int map_mV_to_note_number(int mV) {
  * The conversion assumes that each note number corresponds to an increment of 
  * 83.3333 mV. The result is calculated using a simple multiplication.
  *
+ * To avoid float math, note_number * 83.3333 is done as note_number * 5461331 / 2^16,
+ * truncated towards zero, which gives the same result for notes from -393 to 393.
+ *
  * @param note_number The musical note number to be converted.
  * @return An integer representing the equivalent voltage in millivolts.
  */
 int map_note_number_to_mV(int note_number) {
 
-  int mV = note_number * 83.3333f;
+  long mV = ((long)abs(note_number) * 5461331) >> 16;
+  if (note_number < 0) mV = -mV;
   return mV;
 }
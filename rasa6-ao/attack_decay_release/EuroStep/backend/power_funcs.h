@@ -34,6 +34,9 @@ long power_long(int a, int b) {
  * @param a The base.
  * @param b The exponent (expected to be non-negative).
  * @return The result of a raised to the power of b.
+ *
+ * @note This calls exp() and log(), so power_Q16() (see exp_funcs.h) is faster for
+ *       code that runs every step.
  */
 float power_float(float a, float b) {
   float c = exp(b * log(a));
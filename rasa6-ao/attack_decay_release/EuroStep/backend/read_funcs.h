@@ -38,6 +38,43 @@ float read_analog_mV(int pin_in, int r1 = 0, int r2 = 0, bool debug = false) {
   return (mV);
 }
 
+/**
+ * Reads an analog input pin and returns the raw 10-bit reading (0 to 1023).
+ *
+ * Like read_analog_mV(), the pin is read twice and the first reading is thrown away,
+ * which gives the ADC time to settle after switching pins.
+ *
+ * @param pin_in The analog input pin to read from.
+ * @return The raw reading from analogRead().
+ */
+int read_analog_reading(int pin_in) {
+  analogRead(pin_in);
+  return analogRead(pin_in);
+}
+
+/**
+ * Adds a value to a history of the last 8 values and returns their average.
+ *
+ * @param mV The newest value (in millivolts).
+ * @param read_history An array of 8 integers to store the history of recent values.
+ * @return The average of the last 8 values.
+ */
+int smooth_mV(int mV, int read_history[8]) {
+
+  // track history of input
+  for (int i = 0; i < 7; i++) {  // move history back one step
+    read_history[i] = read_history[i + 1];
+  }
+  read_history[7] = mV;  // update history with new value
+
+  // calculate average of history
+  long incoming_cv = 0;
+  for (int i = 0; i < 8; i++) {  // calculate grand sum of history
+    incoming_cv = incoming_cv + read_history[i];
+  }
+  return incoming_cv / 8;
+}
+
 /**
  * Reads an analog input pin, applies a smoothing filter using a history buffer, 
  * and returns the average voltage in millivolts (mV).
@@ -62,18 +99,7 @@ float read_analog_mV(int pin_in, int r1 = 0, int r2 = 0, bool debug = false) {
  */
 int read_analog_mV_smooth(int pin_in, int read_history[8], int r1 = 0, int r2 = 0, bool debug = false) {
 
-  // track history of input
-  for (int i = 0; i < 8; i++) {  // move history back one step
-    read_history[i] = read_history[i + 1];
-  }
-  read_history[7] = read_analog_mV(pin_in, r1, r2);  // update history with new value
-
-  // calculate average of history
-  long incoming_cv = 0;
-  for (int i = 0; i < 8; i++) {  // calculate grand sum of history
-    incoming_cv = incoming_cv + read_history[i];
-  }
-  incoming_cv = incoming_cv / 8;
+  int incoming_cv = smooth_mV(read_analog_mV(pin_in, r1, r2), read_history);
 
   if (debug) {
     Serial.print("Current value (read_analog_mV_smooth): ");
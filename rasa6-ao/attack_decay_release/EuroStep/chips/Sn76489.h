@@ -1,3 +1,52 @@
+/*
+Class Name: Sn76489
+
+Purpose: Write tones and volumes to a SN76489 sound chip.
+
+Dependencies: 'flash_tables.h' (for the pitch table).
+
+Use: Create an instance of the class and configure settings, then run:
+-- set_pins(we, ce, d0, d1, d2, d3, d4, d5, d6, d7): the pins wired to the chip (set as outputs)
+-- -- note: as in the data sheet, D0 is the most significant bit
+-- send_volume_to_channel_1(volume): set the volume of a channel (0 is off, 15 is loudest)
+-- send_tone_to_channel_1(divider): set the pitch of a channel by its 10-bit divider (1-1023)
+-- -- note: the frequency is master_clock / (32 * divider)
+-- send_note_to_channel_1(note_number): set the pitch of a channel by note number (69 is A440)
+-- send_mV_to_channel_1(mV): set the pitch of a channel by a 1V/oct voltage
+-- send_tone_to_channel_noise(value): set the noise type (0-7, see the data sheet)
+-- write_byte(value): write a latch or data byte as it is (e.g., from a register stream)
+-- write_vgm_command(command, value, 0): write a command from a register stream (see VgmPlayer.h)
+
+You may wish to configure the following settings:
+-- set_master_clock(Hz): the clock for the write timing (default: SN76489_MASTER_CLOCK)
+-- -- note: the pitch table is built for SN76489_MASTER_CLOCK, so define it before including
+-- -- this file if your chip runs at another clock (default: 4 MHz)
+-- -- note: 0V plays SN76489_NOTE_AT_ZERO_VOLTS (default: 48, or C3)
+
+The driver remembers what each channel holds, so only changed values are sent. A tone
+change that only touches the low 4 bits (or, if the channel is still latched, only the high
+6 bits) is sent as one byte instead of two. Pitch comes from a table in flash, so no division
+is done at runtime.
+*/
+
+#ifndef SN76489_MASTER_CLOCK
+#define SN76489_MASTER_CLOCK 4000000L
+#endif
+
+#ifndef SN76489_NOTE_AT_ZERO_VOLTS
+#define SN76489_NOTE_AT_ZERO_VOLTS 48
+#endif
+
+// 10-bit divider for each note number (69 is A440), clamped to what the chip can play
+struct Sn76489Divider {
+  typedef uint16_t value_type;
+  static constexpr value_type value(int note_number) {
+    return constexpr_clamp(constexpr_round(SN76489_MASTER_CLOCK / (32.0 * 440.0 * constexpr_exp2((note_number - 69) / 12.0))), 1, 1023);
+  }
+};
+
+typedef FlashTable<Sn76489Divider, 128> Sn76489DividerTable;
+
 class Sn76489 {
 
 private:
@@ -13,71 +62,57 @@ private:
   int PIN_D6;
   int PIN_D7;
 
-  // second byte used only for tone
-  bool dac_code[16] = { false };
-  bool use_byte_2 = true;
-
-  int master_clock_frequency;
-  int previous_volume = 0;
-  int previous_tone = 0;
-
-  void enable_byte_2(bool value) {
-    use_byte_2 = value;
-    dac_code[8] = 0;
-    dac_code[9] = 0;
-  }
-
-  void use_channel_1() {
-    dac_code[0] = 1;
-    dac_code[1] = 0;
-    dac_code[2] = 0;
-  };
+  // how long the chip needs to take in a byte (32 clock cycles)
+  long master_clock_frequency = SN76489_MASTER_CLOCK;
+  int write_micros = 32000000L / SN76489_MASTER_CLOCK + 1;
 
-  void use_channel_2() {
-    dac_code[0] = 1;
-    dac_code[1] = 0;
-    dac_code[2] = 1;
-  };
+  // what the chip holds, for channels 1-3 and noise (-1 before anything is sent)
+  int previous_tone[4] = { -1, -1, -1, -1 };
+  int previous_volume[4] = { -1, -1, -1, -1 };
 
-  void use_channel_3() {
-    dac_code[0] = 1;
-    dac_code[1] = 1;
-    dac_code[2] = 0;
-  };
-
-  void use_channel_noise() {
-    dac_code[0] = 1;
-    dac_code[1] = 1;
-    dac_code[2] = 1;
-  };
+  // the register that data bytes (the high 6 bits of a tone) go to
+  byte latched_register = 0xFF;
 
   ///////////////////////////////////////////////////////////////////////////////
   /// Backend: Write to Chip
   ///////////////////////////////////////////////////////////////////////////////
 
-  void write_to_chip() {
-    // TO DO!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-    if (use_byte_2) {
-      // TO DO!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-    }
+  void write_to_chip(byte value) {
+
+    // D0 is the most significant bit
+    digitalWrite(PIN_D0, get_bit(value, 7));
+    digitalWrite(PIN_D1, get_bit(value, 6));
+    digitalWrite(PIN_D2, get_bit(value, 5));
+    digitalWrite(PIN_D3, get_bit(value, 4));
+    digitalWrite(PIN_D4, get_bit(value, 3));
+    digitalWrite(PIN_D5, get_bit(value, 2));
+    digitalWrite(PIN_D6, get_bit(value, 1));
+    digitalWrite(PIN_D7, get_bit(value, 0));
+
+    // pulse write enable for long enough for the chip to take in the byte
+    digitalWrite(PIN_CE, LOW);
+    digitalWrite(PIN_WE, LOW);
+    delayMicroseconds(write_micros);
+    digitalWrite(PIN_WE, HIGH);
+    digitalWrite(PIN_CE, HIGH);
   };
 
+  // latch byte: 1, channel (2 bits), 0 for tone or 1 for volume, then 4 bits of data
+  byte latch_byte(int channel, bool is_volume, int data) {
+    return 0x80 | (channel << 5) | (is_volume << 4) | (data & 0x0F);
+  }
+
   ///////////////////////////////////////////////////////////////////////////////
   /// Backend: Write Volume
   ///////////////////////////////////////////////////////////////////////////////
 
-  void map_volume_to_dac_code() {
-    enable_byte_2(false);
-    // TO DO!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-  };
-
-  void write_volume(int new_volume) {
-    new_volume = transfer_value_to_range(new_volume, 0, 31);
-    new_volume = 31 - new_volume;  // invert volume amount to attenuation amount
-    if (new_volume != previous_volume) {
-      map_volume_to_dac_code();
-      write_to_chip();
-      previous_volume = new_volume;
+  void write_volume(int channel, int new_volume) {
+    new_volume = transfer_value_to_range(new_volume, 0, 15);
+    if (new_volume != previous_volume[channel]) {
+      byte reg = latch_byte(channel, true, 15 - new_volume);  // invert volume amount to attenuation amount
+      write_to_chip(reg);
+      latched_register = reg & 0xF0;
+      previous_volume[channel] = new_volume;
     }
   };
 
@@ -85,19 +120,51 @@ private:
   /// Backend: Write Tone
   ///////////////////////////////////////////////////////////////////////////////
 
-  void map_tone_to_dac_code() {
-    enable_byte_2(true);
-    // TO DO!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-  };
+  void write_tone(int channel, int new_tone) {
+    new_tone = transfer_value_to_range(new_tone, (channel == 3) ? 0 : 1, (channel == 3) ? 7 : 1023);
+    int old_tone = previous_tone[channel];
+    if (new_tone == old_tone) return;
+    byte reg = latch_byte(channel, false, new_tone);
+
+    // the noise register only has 3 bits, so it is always one byte
+    if (channel == 3) {
+      write_to_chip(reg);
+      latched_register = reg & 0xF0;
+      previous_tone[channel] = new_tone;
+      return;
+    }
 
-  void write_tone(int new_tone) {
-    if (new_tone != previous_tone) {
-      map_tone_to_dac_code();
-      write_to_chip();
-      previous_tone = new_tone;
+    bool low_bits_changed = (old_tone < 0) || ((new_tone ^ old_tone) & 0x0F);
+    bool high_bits_changed = (old_tone < 0) || ((new_tone ^ old_tone) & 0x3F0);
+    if (low_bits_changed || latched_register != (reg & 0xF0)) {
+      write_to_chip(reg);  // a latch byte also sets the low 4 bits
+      latched_register = reg & 0xF0;
+    }
+    if (high_bits_changed) {
+      write_to_chip((new_tone >> 4) & 0x3F);  // a data byte sets the high 6 bits
     }
+    previous_tone[channel] = new_tone;
   };
 
+  // look up the divider for a note, interpolating by 1/256 of a note
+  int map_note_Q8_to_divider(long note_Q8) {
+    if (note_Q8 < 0) note_Q8 = 0;
+    if (note_Q8 > (127L << 8)) note_Q8 = 127L << 8;
+    int index = note_Q8 >> 8;
+    int fraction = note_Q8 & 255;
+    int divider = pgm_read_word(Sn76489DividerTable::values + index);
+    if (fraction > 0) {
+      int next_divider = pgm_read_word(Sn76489DividerTable::values + index + 1);
+      divider += ((long)(next_divider - divider) * fraction) >> 8;
+    }
+    return divider;
+  }
+
+  void write_mV(int channel, int mV) {
+    long note_Q8 = ((long)mV * 3146 >> 10) + ((long)SN76489_NOTE_AT_ZERO_VOLTS << 8);  // 12 notes per 1000 mV
+    write_tone(channel, map_note_Q8_to_divider(note_Q8));
+  }
+
 
 public:
 
@@ -112,38 +179,52 @@ public:
     PIN_D5 = d5;
     PIN_D6 = d6;
     PIN_D7 = d7;
+
+    // drive the bus, and keep the chip deselected until the first write
+    int pins[10] = { PIN_WE, PIN_CE, PIN_D0, PIN_D1, PIN_D2, PIN_D3, PIN_D4, PIN_D5, PIN_D6, PIN_D7 };
+    for (int i = 0; i < 10; i++) {
+      pinMode(pins[i], OUTPUT);
+    }
+    digitalWrite(PIN_WE, HIGH);
+    digitalWrite(PIN_CE, HIGH);
   };
 
   ///////////////////////////////////////////////////////////////////////////////
   /// Setters
   ///////////////////////////////////////////////////////////////////////////////
 
-  void set_master_clock(int value) {
+  void set_master_clock(long value) {
     master_clock_frequency = value;
+    write_micros = 32000000L / master_clock_frequency + 1;
   };
 
+  // forget what the chip holds (e.g., after it is reset) so all values are sent again
+  void invalidate_registers() {
+    for (int i = 0; i < 4; i++) {
+      previous_tone[i] = -1;
+      previous_volume[i] = -1;
+    }
+    latched_register = 0xFF;
+  }
+
   ///////////////////////////////////////////////////////////////////////////////
   /// Volume Front-end
   ///////////////////////////////////////////////////////////////////////////////
 
   void send_volume_to_channel_1(int value) {
-    use_channel_1();
-    write_volume(value);
+    write_volume(0, value);
   };
 
   void send_volume_to_channel_2(int value) {
-    use_channel_2();
-    write_volume(value);
+    write_volume(1, value);
   };
 
   void send_volume_to_channel_3(int value) {
-    use_channel_3();
-    write_volume(value);
+    write_volume(2, value);
   };
 
   void send_volume_to_channel_noise(int value) {
-    use_channel_noise();
-    write_volume(value);
+    write_volume(3, value);
   };
 
   ///////////////////////////////////////////////////////////////////////////////
@@ -151,25 +232,78 @@ public:
   ///////////////////////////////////////////////////////////////////////////////
 
   void send_tone_to_channel_1(int value) {
-    use_channel_1();
-    write_volume(value);
+    write_tone(0, value);
   };
 
   void send_tone_to_channel_2(int value) {
-    use_channel_2();
-    write_volume(value);
+    write_tone(1, value);
   };
 
   void send_tone_to_channel_3(int value) {
-    use_channel_3();
-    write_volume(value);
+    write_tone(2, value);
   };
 
   void send_tone_to_channel_noise(int value) {
-    use_channel_noise();
-    write_volume(value);
+    write_tone(3, value);
+  };
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Pitch Front-end
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void send_note_to_channel_1(int note_number) {
+    write_tone(0, map_note_Q8_to_divider((long)note_number << 8));
+  };
+
+  void send_note_to_channel_2(int note_number) {
+    write_tone(1, map_note_Q8_to_divider((long)note_number << 8));
   };
 
+  void send_note_to_channel_3(int note_number) {
+    write_tone(2, map_note_Q8_to_divider((long)note_number << 8));
+  };
+
+  void send_mV_to_channel_1(int mV) {
+    write_mV(0, mV);
+  };
+
+  void send_mV_to_channel_2(int mV) {
+    write_mV(1, mV);
+  };
+
+  void send_mV_to_channel_3(int mV) {
+    write_mV(2, mV);
+  };
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Raw Front-end
+  ///////////////////////////////////////////////////////////////////////////////
+
+  // write a byte as it is, while keeping track of what the chip holds
+  void write_byte(byte value) {
+    if (value & 0x80) latched_register = value & 0xF0;
+    if (latched_register != 0xFF) {
+      int channel = (latched_register >> 5) & 3;
+      if (latched_register & 0x10) {
+        previous_volume[channel] = 15 - (value & 0x0F);  // attenuation back to volume
+      } else if (channel == 3) {
+        previous_tone[channel] = value & 0x07;
+      } else if (previous_tone[channel] >= 0) {  // otherwise half the tone is still unknown
+        if (value & 0x80) {
+          previous_tone[channel] = (previous_tone[channel] & 0x3F0) | (value & 0x0F);
+        } else {
+          previous_tone[channel] = (previous_tone[channel] & 0x0F) | ((value & 0x3F) << 4);
+        }
+      }
+    }
+    write_to_chip(value);
+  }
+
+  // write a command from a register stream, ignoring those for other chips
+  void write_vgm_command(byte command, byte value, byte) {
+    if (command == 0x50) write_byte(value);
+  }
+
   ///////////////////////////////////////////////////////////////////////////////
   /// Other Wrappers
   ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,205 @@
+/*
+Class Name: VgmPlayer
+
+Purpose: Play a register log (a subset of the VGM format) from flash to a sound chip.
+
+Dependencies: This class inherits from the Timer class. Include the chip driver first
+(YM2149, YM2612 or Sn76489), as the player writes through its write_vgm_command().
+
+Use: Create an instance of the class for a chip (e.g., VgmPlayer<YM2612> Player), then run:
+-- set_chip(&chip): the chip to write to
+-- set_stream(stream_array, stream_length, loop_position): a stream from 'tools/vgm_to_header.py'
+-- run_player(): write every command that is due (call this as often as possible)
+
+You will eventually want to start the player:
+-- restart_player(): play from the start of the stream
+
+You may also want other player options:
+-- sync_player(): jump to the loop position now (e.g., from on_clock_rise_do() to lock
+-- -- the loop to an external clock)
+-- pause_player(): pause the player
+-- start_player(): unpause the player
+-- loop_player(): go back to the loop position at the end of the stream
+-- unloop_player(): stop at the end of the stream (default)
+-- is_playing(): false once paused or at the end of a stream that does not loop
+
+You may wish to configure the following settings:
+-- set_max_lag(value): how far (in micros) the player may fall behind before it skips ahead
+-- -- instead of catching up (default: 100000)
+
+The stream holds these VGM commands (anything else ends the stream):
+-- 0x50 dd: Sn76489 byte, 0x52 aa dd / 0x53 aa dd: YM2612 part I / II, 0xA0 aa dd: YM2149
+-- 0x61 nn nn: wait n samples, 0x62 / 0x63: wait 735 / 882 samples, 0x7n: wait n + 1 samples
+-- 0x66: end of stream
+
+Waits are kept on an absolute schedule (at 44100 samples per second), so every command
+that is due is written in the same call and the player never drifts. The chip drivers
+pace their own writes, so bursts go out as fast as the chip can take them.
+*/
+
+template<class Chip>
+class VgmPlayer : public Timer {
+
+private:
+
+  Chip* chip = nullptr;
+
+  // the stream, in PROGMEM
+  const byte* stream = nullptr;
+  unsigned int stream_length = 0;
+  unsigned int loop_position = 0;
+  unsigned int position = 0;
+
+  // how long after the timer started the next command is due
+  unsigned long wait_micros = 0;
+  uint16_t wait_fraction = 0;  // in 1/1024ths of a micro, carried into the next wait
+  unsigned long max_lag_micros = 100000;
+
+  bool pause = true;
+  bool loop = false;
+
+  byte next_byte() {
+    return pgm_read_byte(stream + position++);
+  }
+
+  void wait_samples(unsigned long samples) {
+    unsigned long wait_Q10 = samples * 23220 + wait_fraction;  // 1000000 / 44100 = 22.676 micros per sample
+    wait_micros += wait_Q10 >> 10;
+    wait_fraction = wait_Q10 & 1023;
+  }
+
+  bool end_of_stream() {
+    if (loop) {
+      position = loop_position;
+    } else {
+      pause = true;
+    }
+    return false;  // wait for the next call, even if looping, so a stream without waits cannot hang
+  }
+
+  // write commands until the next wait, returns false at the end of the stream
+  bool run_until_wait() {
+    while (wait_micros == 0) {
+      if (position >= stream_length) return end_of_stream();
+      byte command = next_byte();
+      if ((command & 0xF0) == 0x70) {
+        wait_samples((command & 0x0F) + 1);
+        continue;
+      }
+      switch (command) {
+        case 0x50:
+          chip->write_vgm_command(command, next_byte(), 0);
+          break;
+        case 0x52:
+        case 0x53:
+        case 0xA0:
+          {
+            byte reg = next_byte();
+            byte val = next_byte();
+            chip->write_vgm_command(command, reg, val);
+            break;
+          }
+        case 0x61:
+          {
+            unsigned int samples = next_byte();
+            samples |= (unsigned int)next_byte() << 8;
+            wait_samples(samples);
+            break;
+          }
+        case 0x62:
+          wait_samples(735);
+          break;
+        case 0x63:
+          wait_samples(882);
+          break;
+        default:
+          return end_of_stream();  // 0x66, or a command the player does not know
+      }
+    }
+    return true;
+  }
+
+  void jump_to(unsigned int new_position) {
+    position = new_position;
+    wait_micros = 0;
+    wait_fraction = 0;
+    use_micros();
+    reset_timer();
+  }
+
+public:
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Getters and setters
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void set_chip(Chip* value) {
+    chip = value;
+  }
+
+  void set_stream(const byte* stream_array, unsigned int length, unsigned int loop_at = 0) {
+    stream = stream_array;
+    stream_length = length;
+    loop_position = (loop_at < length) ? loop_at : 0;
+    pause = true;
+    jump_to(0);
+  }
+
+  void set_max_lag(unsigned long value) {
+    max_lag_micros = value;
+  }
+
+  bool is_playing() {
+    return !pause;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Player functions
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void pause_player(bool new_value = true) {
+    pause = new_value;
+  }
+
+  void start_player() {
+    pause = false;
+  }
+
+  void loop_player(bool new_value = true) {
+    loop = new_value;
+  }
+
+  void unloop_player() {
+    loop = false;
+  }
+
+  void restart_player() {
+    jump_to(0);
+    start_player();
+  }
+
+  void sync_player() {
+    jump_to(loop_position);
+    start_player();
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Run the player
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void run_player() {
+    if (pause || chip == nullptr || stream == nullptr) return;
+
+    // too far behind to catch up (e.g., the sketch was busy), so carry on from now
+    if (get_timer() > wait_micros + max_lag_micros) {
+      reset_timer();
+      wait_micros = 0;
+    }
+
+    while (!pause && get_timer() >= wait_micros) {
+      advance_timer(wait_micros);  // keep the schedule, however late this call is
+      wait_micros = 0;
+      if (!run_until_wait()) break;
+    }
+  }
+};
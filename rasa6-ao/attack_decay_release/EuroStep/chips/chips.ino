@@ -1,9 +1,12 @@
 #include "C:/Users/61436/Dropbox/Hobbies/Electronics/GitHub/devkit/EuroStep/backend/bit_funcs.h"
 #include "C:/Users/61436/Dropbox/Hobbies/Electronics/GitHub/devkit/EuroStep/backend/transfer_funcs.h"
+#include "C:/Users/61436/Dropbox/Hobbies/Electronics/GitHub/devkit/EuroStep/backend/flash_tables.h"
+#include "C:/Users/61436/Dropbox/Hobbies/Electronics/GitHub/devkit/EuroStep/backend/Timer.h"
 #include "dummy.h"  // dummy pins to test compile
 #include "Sn76489.h"
 #include "ym2149.h"
 #include "ym2612.h"
+#include "VgmPlayer.h"
 
 void setup() {
   // put your setup code here, to run once:
@@ -1,3 +1,28 @@
+/*
+Class Name: YM2149
+
+Purpose: Write to (and read from) the registers of a YM2149 / AY-3-8910 sound chip.
+
+Dependencies: The pins PIN_DA0 to PIN_DA7, PIN_BDIR, PIN_BC1 and PIN_BC2 must be defined.
+
+Use: Create an instance of the class and then run:
+-- set_reg_to_val(reg, val): write a value to one of the 16 registers
+-- read(reg): read a value back from a register
+-- write_vgm_command(command, reg, val): write a command from a register stream (see VgmPlayer.h)
+
+The driver keeps a copy of the registers, so writing a register with the value it
+already holds does nothing. This makes it cheap to update the chip every step. Writes
+to the envelope shape (register 13) are always sent, since they restart the envelope,
+and so are writes to the I/O ports (registers 14 and 15).
+-- invalidate_registers(): forget the copy (e.g., after the chip is reset) so all writes are sent
+
+When PIN_DA0 to PIN_DA7 are bits 0 to 7 of one port (e.g., 0 to 7 on an Uno or Nano),
+the data byte is written with one port write instead of eight digitalWrite() calls.
+
+Define YM2149_VERBOSE before including this file to print every byte over Serial
+(and then set verbose to true).
+*/
+
 // terms used to make it easy to set registers
 #define YM2149_MIXER 7
 #define YM2149_VOLUME 8
@@ -9,9 +34,46 @@
 
 class YM2149 {
 
+private:
+
+  // copy of what the chip holds, so unchanged values are not sent again
+  byte registers[YM2149_ENV_SHAPE];
+  uint16_t registers_known = 0;  // one bit per register
+
+  bool is_cached(byte index) {
+    return index < YM2149_ENV_SHAPE;  // the envelope shape and I/O ports are always sent
+  }
+
+  // track the data bus, so pinMode() is only called when the direction changes
+  bool data_bus_is_output = false;
+  bool data_bus_is_checked = false;
+
+#if defined(__AVR__)
+  // used to write the whole data byte at once
+  volatile uint8_t* data_port_output = nullptr;
+  volatile uint8_t* data_port_input = nullptr;
+  volatile uint8_t* data_port_mode = nullptr;
+#endif
+
+  // use the port directly if all data pins are bits 0 to 7 of the same port, in order
+  void check_data_bus() {
+    data_bus_is_checked = true;
+#if defined(__AVR__)
+    uint8_t port = digitalPinToPort(data_pin[0]);
+    if (port == NOT_A_PORT) return;
+    for (int i = 0; i < 8; i++) {
+      if (digitalPinToPort(data_pin[i]) != port) return;
+      if (digitalPinToBitMask(data_pin[i]) != (1 << i)) return;
+    }
+    data_port_output = portOutputRegister(port);
+    data_port_input = portInputRegister(port);
+    data_port_mode = portModeRegister(port);
+#endif
+  }
+
 public:
 
-  bool verbose = true;
+  bool verbose = false;
   int data_pin[8] = { PIN_DA0, PIN_DA1, PIN_DA2, PIN_DA3, PIN_DA4, PIN_DA5, PIN_DA6, PIN_DA7 };
 
   ///////////////////////////////////////////////////////////////////////////////
@@ -49,15 +111,35 @@ public:
   }
 
   void config_DA_as_output() {
+    if (!data_bus_is_checked) check_data_bus();
+    if (data_bus_is_output) return;
+#if defined(__AVR__)
+    if (data_port_mode != nullptr) {
+      *data_port_mode = 0xFF;
+      data_bus_is_output = true;
+      return;
+    }
+#endif
     for (int i = 0; i < 8; i++) {
       pinMode(data_pin[i], OUTPUT);
     }
+    data_bus_is_output = true;
   }
 
   void config_DA_as_input() {
+    if (!data_bus_is_checked) check_data_bus();
+#if defined(__AVR__)
+    if (data_port_mode != nullptr) {
+      *data_port_mode = 0x00;
+      *data_port_output = 0x00;  // no pull-ups
+      data_bus_is_output = false;
+      return;
+    }
+#endif
     for (int i = 0; i < 8; i++) {
       pinMode(data_pin[i], INPUT);
     }
+    data_bus_is_output = false;
   }
 
   ///////////////////////////////////////////////////////////////////////////////
@@ -66,6 +148,7 @@ public:
 
   void set_byte(char byte) {
 
+#ifdef YM2149_VERBOSE
     if (verbose) {
       Serial.print("Setting byte: ");
       for (int i = 7; i > -1; i--) {  // print from i=7 (DA7) then descend1
@@ -73,7 +156,14 @@ public:
       }
       Serial.println("");
     }
+#endif
 
+#if defined(__AVR__)
+    if (data_port_output != nullptr) {
+      *data_port_output = byte;
+      return;
+    }
+#endif
     for (int i = 0; i < 8; i++) {
       digitalWrite(data_pin[i], get_bit(byte, i));
     }
@@ -95,6 +185,15 @@ public:
 
   void set_reg_to_val(char reg, char val) {
 
+    // skip values the chip already holds
+    byte index = reg & 15;
+    if (is_cached(index)) {
+      bool is_known = registers_known & (1U << index);
+      if (is_known && registers[index] == (byte)val) return;
+      registers[index] = val;
+      registers_known |= (1U << index);
+    }
+
     // setup bus to write
     latch(reg);
     config_010();
@@ -109,6 +208,15 @@ public:
     config_000();
   }
 
+  void invalidate_registers() {
+    registers_known = 0;
+  }
+
+  // write a command from a register stream (see VgmPlayer.h), ignoring those for other chips
+  void write_vgm_command(byte command, byte reg, byte val) {
+    if (command == 0xA0) set_reg_to_val(reg, val);
+  }
+
   int read(char reg) {
 
     // setup bus to read
@@ -119,20 +227,36 @@ public:
     config_DA_as_input();
     config_read();
 
+    // read byte as integer using bitwise logic
+    int result = 0;
+#if defined(__AVR__)
+    if (data_port_input != nullptr) {
+      result = *data_port_input;
+    } else
+#endif
+    {
+      for (int i = 0; i < 8; i++) {
+        int value = digitalRead(data_pin[i]);
+        result |= (value << i);  // i=0 (DA0) goes in first place, i=1 (DA1) in second place, and so on
+      }
+    }
+
     // optional: print byte to console
+#ifdef YM2149_VERBOSE
     if (verbose) {
       Serial.print("Reading byte: ");
       for (int i = 7; i > -1; i--) {  // print from i=7 (DA7) then descend
-        Serial.print(digitalRead(data_pin[i]));
+        Serial.print(get_bit(result, i));
       }
       Serial.println("");
     }
+#endif
 
-    // read byte as integer using bitwise logic
-    int result = 0;
-    for (int i = 0; i < 8; i++) {
-      int value = digitalRead(data_pin[i]);
-      result |= (value << i);  // i=0 (DA0) goes in first place, i=1 (DA1) in second place, and so on
+    // the chip now holds what was read
+    byte index = reg & 15;
+    if (is_cached(index)) {
+      registers[index] = result;
+      registers_known |= (1U << index);
     }
 
     // clean up
@@ -1,43 +1,193 @@
+/*
+Class Name: YM2612
+
+Purpose: Write to the registers of a YM2612 (OPN2) FM sound chip.
+
+Dependencies: The pins PIN_DA0 to PIN_DA7, PIN_CS, PIN_WR, PIN_RD, PIN_A0 and PIN_A1 must be defined.
+
+Use: Create an instance of the class and then run:
+-- set_reg_to_val(reg, val): write a value to a register in part I (channels 1-3 and global registers)
+-- set_reg_to_val(reg, val, true): write a value to a register in part II (channels 4-6)
+-- write_vgm_command(command, reg, val): write a command from a register stream (see VgmPlayer.h)
+
+The driver keeps a copy of registers 0x20 to 0xB7 in both parts, so writing a register
+with the value it already holds does nothing. Some writes are always sent:
+-- 0x24 to 0x28 (timers and key on/off), since writing them has an effect every time
+-- 0xA4 to 0xA6 (and 0xAC to 0xAE), since all of these write one shared latch for the
+-- -- high byte and block, which goes to whichever channel's low byte is written next
+-- 0xA0 to 0xA2 (and 0xA8 to 0xAA) after a high byte, so the latch goes to that channel
+-- invalidate_registers(): forget the copy (e.g., after the chip is reset) so all writes are sent
+-- -- note: the copy uses about 340 bytes of RAM
+
+Instead of waiting the worst case after every byte, the driver remembers when the chip
+will be ready again and only waits if the next write comes too soon:
+-- use_busy_flag(): wait by reading the busy flag through PIN_RD instead
+-- set_clock_frequency(Hz): for the wait times (default: 7670453 Hz, as in the Mega Drive)
+*/
+
+// registers kept in the copy
+#define YM2612_FIRST_CACHED_REG 0x20
+#define YM2612_LAST_CACHED_REG 0xB7
+#define YM2612_CACHED_REGS (YM2612_LAST_CACHED_REG - YM2612_FIRST_CACHED_REG + 1)
+
 class YM2612 {
 
+private:
+
+  // copy of what the chip holds, so unchanged values are not sent again
+  byte registers[2][YM2612_CACHED_REGS];
+  byte registers_known[2][(YM2612_CACHED_REGS + 7) / 8] = { { 0 } };  // one bit per register
+
+  // when the chip can next be written to
+  unsigned long ready_at_micros = 0;
+  bool wait_on_busy_flag = false;
+  bool data_bus_is_output = false;
+
+  // wait times in chip cycles (from the data sheet), converted to micros by the clock
+  long clock_frequency = 7670453;
+  int micros_after_address = 4;
+  int micros_after_data = 12;
+  int micros_after_frequency_data = 8;
+
+  static bool is_frequency_high_byte(byte reg) {
+    return (reg >= 0xA4 && reg <= 0xA6) || (reg >= 0xAC && reg <= 0xAE);
+  }
+
+  bool is_cached(byte reg) {
+    if (reg < YM2612_FIRST_CACHED_REG || reg > YM2612_LAST_CACHED_REG) return false;
+    if (is_frequency_high_byte(reg)) return false;  // the latch is shared, so always write it
+    return reg < 0x24 || reg > 0x28;
+  }
+
+  bool is_known(bool part, byte index) {
+    return registers_known[part][index >> 3] & (1 << (index & 7));
+  }
+
+  void set_known(bool part, byte index, bool value) {
+    if (value) {
+      registers_known[part][index >> 3] |= (1 << (index & 7));
+    } else {
+      registers_known[part][index >> 3] &= ~(1 << (index & 7));
+    }
+  }
+
+  int cycles_to_micros(long cycles) {
+    return (cycles * 1000000L + clock_frequency - 1) / clock_frequency + 1;  // +1 for the micros() resolution
+  }
+
+  void config_DA_as_output() {
+    if (data_bus_is_output) return;
+    for (int i = 0; i < 8; i++) {
+      pinMode(data_pin[i], OUTPUT);
+    }
+    data_bus_is_output = true;
+  }
+
+  void config_DA_as_input() {
+    if (!data_bus_is_output) return;
+    for (int i = 0; i < 8; i++) {
+      pinMode(data_pin[i], INPUT);
+    }
+    data_bus_is_output = false;
+  }
+
+  bool chip_is_busy() {
+    config_DA_as_input();
+    digitalWrite(PIN_A0, 0);
+    digitalWrite(PIN_A1, 0);
+    digitalWrite(PIN_CS, 0);
+    digitalWrite(PIN_RD, 0);
+    bool busy = digitalRead(data_pin[7]);  // D7 is the busy flag
+    digitalWrite(PIN_RD, 1);
+    digitalWrite(PIN_CS, 1);
+    return busy;
+  }
+
+  void wait_until_ready() {
+    if (wait_on_busy_flag) {
+      while (chip_is_busy()) {}
+    } else {
+      while ((long)(micros() - ready_at_micros) < 0) {}
+    }
+  }
+
 public:
 
-  bool verbose = true;
+  bool verbose = false;
   int data_pin[8] = { PIN_DA0, PIN_DA1, PIN_DA2, PIN_DA3, PIN_DA4, PIN_DA5, PIN_DA6, PIN_DA7 };
 
-  void set_byte(char byte) {
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Setters
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void set_clock_frequency(long Hz) {
+    clock_frequency = Hz;
+    micros_after_address = cycles_to_micros(17);
+    micros_after_data = cycles_to_micros(83);
+    micros_after_frequency_data = cycles_to_micros(47);
+  }
+
+  void use_busy_flag(bool value = true) {
+    wait_on_busy_flag = value;
+  }
+
+  void invalidate_registers() {
+    memset(registers_known, 0, sizeof(registers_known));
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Write to the chip
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void set_byte(char byte, bool is_value, bool use_part_2, int micros_until_ready) {
+
+    wait_until_ready();
+
+    // select what to write (after waiting, since reading the busy flag uses A0 and A1)
+    digitalWrite(PIN_A0, is_value);
+    digitalWrite(PIN_A1, use_part_2);  // 1 for chan 4-6
 
     // pass data to chip
+    config_DA_as_output();
+    digitalWrite(PIN_RD, 1);  // not reading
     digitalWrite(PIN_CS, 0);
     for (int i = 0; i < 8; i++) {
       digitalWrite(data_pin[i], get_bit(byte, i));  // write i=0 (DA0) then i=1 (DA1) and so on
     }
-    delayMicroseconds(1);
 
-    // enable write mode
+    // pulse write (each digitalWrite() is longer than the 200 ns the chip needs)
     digitalWrite(PIN_WR, 0);
-    digitalWrite(PIN_RD, 1);
-    delayMicroseconds(5);
-
-    // stop write
     digitalWrite(PIN_WR, 1);
-    digitalWrite(PIN_RD, 0);
-    delayMicroseconds(5);
 
     // finish
     digitalWrite(PIN_CS, 1);
+    ready_at_micros = micros() + micros_until_ready;
   }
 
-  void set_reg_to_val(char reg, char val) {
+  void set_reg_to_val(char reg, char val, bool use_part_2 = false) {
 
-    // write to register
-    digitalWrite(PIN_A0, 0);
-    digitalWrite(PIN_A1, 0);  // set to 1 for chan 4-6
-    set_byte(reg);
+    // skip values the chip already holds
+    byte address = reg;
+    if (is_cached(address)) {
+      byte index = address - YM2612_FIRST_CACHED_REG;
+      if (is_known(use_part_2, index) && registers[use_part_2][index] == (byte)val) return;
+      registers[use_part_2][index] = val;
+      set_known(use_part_2, index, true);
+    }
+
+    // the latch only reaches the channel when its low byte is written, so send that next time
+    if (is_frequency_high_byte(address)) {
+      set_known(use_part_2, address - 4 - YM2612_FIRST_CACHED_REG, false);
+    }
+
+    // write to register, then write value
+    set_byte(reg, false, use_part_2, micros_after_address);
+    set_byte(val, true, use_part_2, (address >= 0xA0) ? micros_after_frequency_data : micros_after_data);
+  }
 
-    // write value
-    digitalWrite(PIN_A0, 1);
-    digitalWrite(PIN_A1, 0);  // set to 1 for chan 4-6
-    set_byte(val);
+  // write a command from a register stream (see VgmPlayer.h), ignoring those for other chips
+  void write_vgm_command(byte command, byte reg, byte val) {
+    if (command == 0x52) set_reg_to_val(reg, val);
+    if (command == 0x53) set_reg_to_val(reg, val, true);
   }
 };
@@ -2,26 +2,46 @@
 /// DEFINE HARDWARE PARAMETERS FOR MODULE
 ///////////////////////////////////////////////////////////////////////////////
 
-#define NUMBER_OF_JACKS 2
-#define V_DIVIDER_R1 220
-#define V_DIVIDER_R2 150
-#define PINS_JACK \
-  { A0, A7 }
-
-#define NUMBER_OF_POTS 6
-#define MAX_POT_VOLTAGE 4900
-#define REVERSE_POT true
-#define PINS_POT \
-  { A2, A6, A5, A1, A3, A4 }
-
-#define NUMBER_OF_SWITCHES 4
-#define PINS_SWITCH \
-  { 12, 11, 10, 9 }
-
-#define NUMBER_OF_DIGITAL_OUTPUTS 0
-#define PINS_DIGITAL_OUTPUT \
-  {}
-#define PINS_DAC_A \
-  { 4, 5, 6, 7 }
-#define PINS_DAC_B \
-  { -1, -1, -1, -1 }
+struct Rasa3x2Board {
+
+  static constexpr int number_of_jacks = 2;
+  static constexpr int v_divider_r1 = 220;
+  static constexpr int v_divider_r2 = 150;
+  static constexpr int pins_jack[number_of_jacks] = { A0, A7 };
+
+  static constexpr int number_of_pots = 6;
+  static constexpr int max_pot_voltage = 4900;
+  static constexpr bool reverse_pot = true;
+  static constexpr int pins_pot[number_of_pots] = { A2, A6, A5, A1, A3, A4 };
+
+  static constexpr int number_of_switches = 4;
+  static constexpr int pins_switch[number_of_switches] = { 12, 11, 10, 9 };
+
+  static constexpr int number_of_digital_outputs = 0;
+  static constexpr int pins_digital_output[number_of_digital_outputs] = {};
+
+  // MCP4822 pins as { cs, sck, sdi, ldac }, where -1 is not connected
+  static constexpr bool has_dac_a = true;
+  static constexpr int pins_dac_a[4] = { 4, 5, 6, 7 };
+  static constexpr bool has_dac_b = false;
+  static constexpr int pins_dac_b[4] = { -1, -1, -1, -1 };
+};
+
+constexpr int Rasa3x2Board::pins_jack[];
+constexpr int Rasa3x2Board::pins_pot[];
+constexpr int Rasa3x2Board::pins_switch[];
+constexpr int Rasa3x2Board::pins_digital_output[];
+constexpr int Rasa3x2Board::pins_dac_a[];
+constexpr int Rasa3x2Board::pins_dac_b[];
+
+typedef Rasa3x2Board Hardware;  // the board that EuroStep is built for
+
+// the same settings as macros, for code written before the board types (e.g., flash_tables.h)
+#define NUMBER_OF_JACKS Rasa3x2Board::number_of_jacks
+#define V_DIVIDER_R1 Rasa3x2Board::v_divider_r1
+#define V_DIVIDER_R2 Rasa3x2Board::v_divider_r2
+#define NUMBER_OF_POTS Rasa3x2Board::number_of_pots
+#define MAX_POT_VOLTAGE Rasa3x2Board::max_pot_voltage
+#define REVERSE_POT Rasa3x2Board::reverse_pot
+#define NUMBER_OF_SWITCHES Rasa3x2Board::number_of_switches
+#define NUMBER_OF_DIGITAL_OUTPUTS Rasa3x2Board::number_of_digital_outputs
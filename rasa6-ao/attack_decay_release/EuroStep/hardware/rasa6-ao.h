@@ -2,26 +2,46 @@
 /// DEFINE HARDWARE PARAMETERS FOR MODULE
 ///////////////////////////////////////////////////////////////////////////////
 
-#define NUMBER_OF_JACKS 1
-#define V_DIVIDER_R1 220
-#define V_DIVIDER_R2 150
-#define PINS_JACK \
-  { A2 }
-
-#define NUMBER_OF_POTS 2
-#define MAX_POT_VOLTAGE 4900
-#define REVERSE_POT true
-#define PINS_POT \
-  { A0, A1 }
-
-#define NUMBER_OF_SWITCHES 0
-#define PINS_SWITCH \
-  {}
-
-#define NUMBER_OF_DIGITAL_OUTPUTS 0
-#define PINS_DIGITAL_OUTPUT \
-  {}
-#define PINS_DAC_A \
-  { 11, 10, 9, -1 }
-#define PINS_DAC_B \
-  { -1, -1, -1, -1 }
+struct Rasa6AoBoard {
+
+  static constexpr int number_of_jacks = 1;
+  static constexpr int v_divider_r1 = 220;
+  static constexpr int v_divider_r2 = 150;
+  static constexpr int pins_jack[number_of_jacks] = { A2 };
+
+  static constexpr int number_of_pots = 2;
+  static constexpr int max_pot_voltage = 4900;
+  static constexpr bool reverse_pot = true;
+  static constexpr int pins_pot[number_of_pots] = { A0, A1 };
+
+  static constexpr int number_of_switches = 0;
+  static constexpr int pins_switch[number_of_switches] = {};
+
+  static constexpr int number_of_digital_outputs = 0;
+  static constexpr int pins_digital_output[number_of_digital_outputs] = {};
+
+  // MCP4822 pins as { cs, sck, sdi, ldac }, where -1 is not connected
+  static constexpr bool has_dac_a = true;
+  static constexpr int pins_dac_a[4] = { 11, 10, 9, -1 };
+  static constexpr bool has_dac_b = false;
+  static constexpr int pins_dac_b[4] = { -1, -1, -1, -1 };
+};
+
+constexpr int Rasa6AoBoard::pins_jack[];
+constexpr int Rasa6AoBoard::pins_pot[];
+constexpr int Rasa6AoBoard::pins_switch[];
+constexpr int Rasa6AoBoard::pins_digital_output[];
+constexpr int Rasa6AoBoard::pins_dac_a[];
+constexpr int Rasa6AoBoard::pins_dac_b[];
+
+typedef Rasa6AoBoard Hardware;  // the board that EuroStep is built for
+
+// the same settings as macros, for code written before the board types (e.g., flash_tables.h)
+#define NUMBER_OF_JACKS Rasa6AoBoard::number_of_jacks
+#define V_DIVIDER_R1 Rasa6AoBoard::v_divider_r1
+#define V_DIVIDER_R2 Rasa6AoBoard::v_divider_r2
+#define NUMBER_OF_POTS Rasa6AoBoard::number_of_pots
+#define MAX_POT_VOLTAGE Rasa6AoBoard::max_pot_voltage
+#define REVERSE_POT Rasa6AoBoard::reverse_pot
+#define NUMBER_OF_SWITCHES Rasa6AoBoard::number_of_switches
+#define NUMBER_OF_DIGITAL_OUTPUTS Rasa6AoBoard::number_of_digital_outputs
@@ -0,0 +1,142 @@
+"""
+Script Name: adpcm_encode.py
+
+Purpose: Encode a WAV file as 4-bit IMA-ADPCM for the Playback class.
+
+Dependencies: Python 3 (standard library only).
+
+Use: python adpcm_encode.py input.wav name > name.h
+-- input.wav: mono or stereo WAV file, 8-bit or 16-bit (only the first channel is used)
+-- name: the name of the C++ array to create
+
+Then in the program:
+-- #include "name.h"
+-- set_adpcm_audio(name, name_length): play the encoded array
+
+The encoder starts from the same state as the Adpcm class (predictor 0, step index 0),
+so the decoder matches it exactly. The compression ratio and signal-to-noise ratio
+versus the 8-bit original are printed to stderr.
+"""
+
+import math
+import sys
+import wave
+
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+]
+
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8]
+
+
+def read_wav_as_bytes(path):
+    """Read the first channel of a WAV file as unsigned 8-bit values (0-255)."""
+    with wave.open(path, "rb") as f:
+        channels = f.getnchannels()
+        width = f.getsampwidth()
+        frames = f.readframes(f.getnframes())
+    values = []
+    for i in range(0, len(frames), channels * width):
+        if width == 1:
+            values.append(frames[i])
+        elif width == 2:
+            sample = int.from_bytes(frames[i:i + 2], "little", signed=True)
+            values.append((sample >> 8) + 128)
+        else:
+            raise ValueError("only 8-bit and 16-bit WAV files are supported")
+    return values
+
+
+def decode_code(code, predictor, step_index):
+    """Run one step of the decoder, exactly as Adpcm::decode_next() does."""
+    step = STEP_TABLE[step_index]
+    difference = step >> 3
+    if code & 4:
+        difference += step
+    if code & 2:
+        difference += step >> 1
+    if code & 1:
+        difference += step >> 2
+    predictor = predictor - difference if code & 8 else predictor + difference
+    predictor = max(-32768, min(32767, predictor))
+    step_index = max(0, min(88, step_index + INDEX_TABLE[code & 7]))
+    return predictor, step_index
+
+
+def encode(values):
+    """Encode unsigned 8-bit values as a list of 4-bit codes, plus the decoded values."""
+    predictor = 0
+    step_index = 0
+    codes = []
+    decoded = []
+    for value in values:
+        target = (value - 128) << 8
+        step = STEP_TABLE[step_index]
+        difference = target - predictor
+        code = 0
+        if difference < 0:
+            code = 8
+            difference = -difference
+        if difference >= step:
+            code |= 4
+            difference -= step
+        if difference >= step >> 1:
+            code |= 2
+            difference -= step >> 1
+        if difference >= step >> 2:
+            code |= 1
+        predictor, step_index = decode_code(code, predictor, step_index)
+        codes.append(code)
+        decoded.append((predictor >> 8) + 128)
+    return codes, decoded
+
+
+def pack_codes(codes):
+    """Pack two codes per byte, low nibble first."""
+    if len(codes) % 2:
+        codes = codes + [0]
+    return [codes[i] | (codes[i + 1] << 4) for i in range(0, len(codes), 2)]
+
+
+def signal_to_noise_dB(original, decoded):
+    signal = sum((v - 128) ** 2 for v in original)
+    noise = sum((a - b) ** 2 for a, b in zip(original, decoded))
+    if noise == 0:
+        return float("inf")
+    if signal == 0:
+        return 0.0
+    return 10 * math.log10(signal / noise)
+
+
+def write_header(name, packed, number_of_values, source, out):
+    out.write("// Generated by adpcm_encode.py from '%s'\n" % source)
+    out.write("// %d values packed into %d bytes of 4-bit IMA-ADPCM\n" % (number_of_values, len(packed)))
+    out.write("const int %s_length = %d;\n" % (name, number_of_values))
+    out.write("const byte %s[] PROGMEM = {\n" % name)
+    for i in range(0, len(packed), 16):
+        row = ", ".join("0x%02X" % b for b in packed[i:i + 16])
+        out.write("  %s,\n" % row)
+    out.write("};\n")
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write(__doc__)
+        sys.exit(1)
+    path, name = sys.argv[1], sys.argv[2]
+    values = read_wav_as_bytes(path)
+    codes, decoded = encode(values)
+    packed = pack_codes(codes)
+    write_header(name, packed, len(values), path, sys.stdout)
+    sys.stderr.write("Values: %d\n" % len(values))
+    sys.stderr.write("Bytes as 8-bit: %d, as ADPCM: %d\n" % (len(values), len(packed)))
+    sys.stderr.write("Compression ratio: %.2f:1\n" % (len(values) / max(1, len(packed))))
+    sys.stderr.write("Signal-to-noise ratio: %.1f dB\n" % signal_to_noise_dB(values, decoded))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,417 @@
+"""
+Script Name: check_fixed_math.py
+
+Purpose: Check the integer math helpers against float math, on the computer.
+
+Dependencies: Python 3 (standard library only) and a C++ compiler (g++ or clang++, with __int128).
+
+Use: python check_fixed_math.py
+-- or: python check_fixed_math.py clang++ (to use another compiler)
+
+The helpers in 'backend/fixed_funcs.h', 'backend/exp_funcs.h' and 'backend/map_funcs.h' are
+compiled with a small stand-in for Arduino.h, then compared with the same maths done in
+double precision. The table shows the largest error (or the number of wrong results) found
+over each sweep.
+
+On the AVR an int is 16 bits and a long is 32 bits, so a sum or product that fits on the
+computer can overflow on the board. To catch these, a copy of each helper is made with its
+integer types and literals swapped for the 'avr<>' types below, which do the maths with AVR
+sizes and promotions and count every signed overflow. The script fails if any helper
+overflows or gives a wrong exact result.
+
+This checks accuracy only, as cycle counts on the computer say little about the AVR
+(time those on a board).
+"""
+
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+BACKEND = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "backend")
+HELPERS = ["fixed_funcs.h", "exp_funcs.h", "map_funcs.h"]
+
+# just enough of Arduino.h for the helpers, with flash reads as plain reads,
+#  and integer types that behave like the AVR ones (int16_t int, int32_t long)
+ARDUINO_STUB = r"""
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdio.h>
+#include <limits>
+#include <type_traits>
+typedef uint8_t byte;
+#define PROGMEM
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+
+unsigned long avr_overflows = 0;
+
+template <typename T> struct avr;
+
+// integer promotion: anything smaller than an int becomes an int (16 bits)
+template <typename T> struct avr_promoted { typedef T type; };
+template <> struct avr_promoted<bool> { typedef int16_t type; };
+template <> struct avr_promoted<int8_t> { typedef int16_t type; };
+template <> struct avr_promoted<uint8_t> { typedef int16_t type; };
+
+// usual arithmetic conversions, with AVR sizes
+template <typename A, typename B> struct avr_common {
+  typedef typename avr_promoted<A>::type PA;
+  typedef typename avr_promoted<B>::type PB;
+  static const bool pick_a = std::is_signed<PA>::value == std::is_signed<PB>::value ? sizeof(PA) >= sizeof(PB)
+                             : std::is_signed<PA>::value                           ? sizeof(PA) > sizeof(PB)
+                                                                                   : sizeof(PA) >= sizeof(PB);
+  typedef typename std::conditional<pick_a, PA, PB>::type type;
+};
+
+// wraps like the AVR, counting signed results that do not fit
+template <typename C> avr<C> avr_result(__int128 r) {
+  if (std::is_signed<C>::value && (r < (__int128)std::numeric_limits<C>::min() || r > (__int128)std::numeric_limits<C>::max())) {
+    avr_overflows++;
+  }
+  return avr<C>((C)r);
+}
+
+template <typename T> struct avr {
+  T v;
+  avr() : v(0) {}
+  template <typename U, typename = typename std::enable_if<std::is_arithmetic<U>::value>::type>
+  avr(U x) : v((T)x) {}
+  template <typename U> avr(avr<U> x) : v((T)x.v) {}
+  operator T() const { return v; }
+  template <typename U> avr& operator+=(U x) { return *this = *this + x; }
+  template <typename U> avr& operator-=(U x) { return *this = *this - x; }
+  template <typename U> avr& operator*=(U x) { return *this = *this * x; }
+  template <typename U> avr& operator/=(U x) { return *this = *this / x; }
+  template <typename U> avr& operator%=(U x) { return *this = *this % x; }
+  template <typename U> avr& operator&=(U x) { return *this = *this & x; }
+  template <typename U> avr& operator|=(U x) { return *this = *this | x; }
+  template <typename U> avr& operator^=(U x) { return *this = *this ^ x; }
+  template <typename U> avr& operator<<=(U x) { return *this = *this << x; }
+  template <typename U> avr& operator>>=(U x) { return *this = *this >> x; }
+  avr& operator++() { return *this = *this + avr<int16_t>(1); }
+  avr& operator--() { return *this = *this - avr<int16_t>(1); }
+  avr operator++(int) { avr old = *this; ++*this; return old; }
+  avr operator--(int) { avr old = *this; --*this; return old; }
+};
+
+// host integers (from the check code) keep their own size
+template <typename H, typename = void> struct avr_host {};
+template <typename H> struct avr_host<H, typename std::enable_if<std::is_integral<H>::value>::type> { typedef H type; };
+
+#define AVR_ARITHMETIC(op)                                                                                  \
+  template <typename A, typename B> avr<typename avr_common<A, B>::type> operator op(avr<A> a, avr<B> b) {  \
+    typedef typename avr_common<A, B>::type C;                                                              \
+    return avr_result<C>((__int128)(C)a.v op (__int128)(C)b.v);                                             \
+  }                                                                                                         \
+  template <typename A, typename H> avr<typename avr_common<A, typename avr_host<H>::type>::type>          \
+  operator op(avr<A> a, H b) { return a op avr<H>(b); }                                                     \
+  template <typename A, typename H> avr<typename avr_common<typename avr_host<H>::type, A>::type>          \
+  operator op(H a, avr<A> b) { return avr<H>(a) op b; }
+
+#define AVR_FLOAT_ARITHMETIC(op)                                                                            \
+  template <typename A> double operator op(avr<A> a, double b) { return (double)a.v op b; }                \
+  template <typename A> double operator op(double a, avr<A> b) { return a op (double)b.v; }
+
+#define AVR_COMPARISON(op)                                                                                  \
+  template <typename A, typename B> bool operator op(avr<A> a, avr<B> b) {                                  \
+    typedef typename avr_common<A, B>::type C;                                                              \
+    return (C)a.v op (C)b.v;                                                                                \
+  }                                                                                                         \
+  template <typename A, typename H> typename std::enable_if<std::is_integral<H>::value, bool>::type         \
+  operator op(avr<A> a, H b) { return a op avr<H>(b); }                                                     \
+  template <typename A, typename H> typename std::enable_if<std::is_integral<H>::value, bool>::type         \
+  operator op(H a, avr<A> b) { return avr<H>(a) op b; }
+
+#define AVR_SHIFT(op)                                                                                       \
+  template <typename A, typename B> avr<typename avr_promoted<A>::type> operator op(avr<A> a, B b) {        \
+    typedef typename avr_promoted<A>::type C;                                                               \
+    return avr_result<C>((__int128)(C)a.v op (int)b);                                                       \
+  }
+
+AVR_ARITHMETIC(+) AVR_ARITHMETIC(-) AVR_ARITHMETIC(*) AVR_ARITHMETIC(/) AVR_ARITHMETIC(%)
+AVR_ARITHMETIC(&) AVR_ARITHMETIC(|) AVR_ARITHMETIC(^)
+AVR_FLOAT_ARITHMETIC(+) AVR_FLOAT_ARITHMETIC(-) AVR_FLOAT_ARITHMETIC(*) AVR_FLOAT_ARITHMETIC(/)
+AVR_COMPARISON(==) AVR_COMPARISON(!=) AVR_COMPARISON(<) AVR_COMPARISON(<=) AVR_COMPARISON(>) AVR_COMPARISON(>=)
+AVR_SHIFT(<<) AVR_SHIFT(>>)
+
+template <typename A> avr<typename avr_promoted<A>::type> operator-(avr<A> a) {
+  typedef typename avr_promoted<A>::type C;
+  return avr_result<C>(-(__int128)(C)a.v);
+}
+template <typename A> avr<typename avr_promoted<A>::type> operator~(avr<A> a) {
+  typedef typename avr_promoted<A>::type C;
+  return avr<C>((C)~(C)a.v);
+}
+template <typename A> avr<typename avr_promoted<A>::type> abs(avr<A> a) { return a < 0 ? -a : avr<typename avr_promoted<A>::type>(a); }
+template <typename A> double ldexp(avr<A> a, int e) { return ldexp((double)a.v, e); }
+
+typedef avr<int8_t> avr_int8_t;
+typedef avr<uint8_t> avr_uint8_t;
+typedef avr<int16_t> avr_int16_t;
+typedef avr<uint16_t> avr_uint16_t;
+typedef avr<int32_t> avr_int32_t;
+typedef avr<uint32_t> avr_uint32_t;
+typedef avr<int64_t> avr_int64_t;
+typedef avr<uint64_t> avr_uint64_t;
+typedef avr<uint8_t> avr_byte;
+typedef avr<int16_t> avr_int;
+typedef avr<uint16_t> avr_uint;
+typedef avr<int32_t> avr_long;
+typedef avr<uint32_t> avr_ulong;
+"""
+
+CHECKS = r"""
+#include "fixed_funcs.h"
+#include "exp_funcs.h"
+#include "map_funcs.h"
+
+static double cents(double ratio) {
+  return fabs(1200.0 * log2(ratio));
+}
+
+static double clamp(double value, double low, double high) {
+  return value < low ? low : value > high ? high : value;
+}
+
+// every value of an int from -32768 to 32767, in steps (with both ends)
+#define FOR_INT(v, step) for (long v = -32768; v <= 32767; v = (v < 32767 && v + (step) > 32767) ? 32767 : v + (step))
+
+// values of a long from -2^31 to 2^31 - 1, in steps (with both ends)
+#define FOR_LONG(v, step) for (long long v = -2147483648LL; v <= 2147483647LL; v = (v < 2147483647LL && v + (step) > 2147483647LL) ? 2147483647LL : v + (step))
+
+int main() {
+
+  // log2_Q16: every value from 1/2 to 2, then powers of 2 apart with a few offsets
+  double log2_error = 0;
+  for (unsigned long v = 32768; v <= 131072; v++) {
+    double error = fabs(log2_Q16(v) / 65536.0 - log2(v / 65536.0));
+    if (error > log2_error) log2_error = error;
+  }
+  for (int shift = 0; shift < 32; shift++) {
+    for (unsigned long offset = 0; offset < 1000; offset += 7) {
+      unsigned long v = (1UL << shift) + offset * (1UL << shift) / 1000;
+      if (v == 0) continue;
+      double error = fabs(log2_Q16(v) / 65536.0 - log2(v / 65536.0));
+      if (error > log2_error) log2_error = error;
+    }
+  }
+
+  // scale_by_exp2: values from 1000 to 1000000, from 4 octaves down to 4 octaves up,
+  //  in cents where the result is big enough (>= 100000) for rounding to a whole number not to matter
+  double exp2_error = 0;
+  for (unsigned long value = 1000; value <= 1000000; value = value * 3 / 2) {
+    for (long octaves = -4L * 65536; octaves <= 4L * 65536; octaves += 97) {
+      double exact = value * exp2(octaves / 65536.0);
+      if (exact < 100000) continue;
+      double error = cents(scale_by_exp2(value, octaves) / exact);
+      if (error > exp2_error) exp2_error = error;
+    }
+  }
+
+  // power_Q16: bases from 1/4 to 4, exponents from -2 to 2 (results from 1/256 to 256)
+  double power_error = 0;
+  for (unsigned long a = 16384; a <= 262144; a += 1013) {
+    for (long b = -131072; b <= 131072; b += 1021) {
+      double exact = pow(a / 65536.0, b / 65536.0) * 65536.0;
+      double error = fabs(power_Q16(a, b) / exact - 1.0);
+      if (error > power_error) power_error = error;
+    }
+  }
+
+  // divide_by_byte: every 16-bit value by every divisor
+  unsigned long divide_errors = 0;
+  for (unsigned long value = 0; value <= 65535; value++) {
+    for (int divisor = 1; divisor <= 255; divisor++) {
+      if (divide_by_byte(value, divisor) != value / divisor) divide_errors++;
+    }
+  }
+
+  // add_Q15, multiply_Q15 and lerp_Q15: the whole int range, in steps, against saturated doubles
+  unsigned long add_Q15_errors = 0;
+  double multiply_Q15_error = 0, lerp_Q15_error = 0;
+  FOR_INT(a, 131) {
+    FOR_INT(b, 127) {
+      if ((long)add_Q15(a, b) != (long)clamp(a + b, -32768, 32767)) add_Q15_errors++;
+      double error = fabs(multiply_Q15(a, b) - clamp(a * (double)b / 32768.0, -32768, 32767));
+      if (error > multiply_Q15_error) multiply_Q15_error = error;
+      for (long t = 0; t <= 32767; t += 4681) {
+        error = fabs(lerp_Q15(a, b, t) - (a + (b - a) * (t / 32768.0)));
+        if (error > lerp_Q15_error) lerp_Q15_error = error;
+      }
+    }
+  }
+
+  // add_Q16, multiply_Q16 and lerp_Q16: the whole long range, in steps
+  unsigned long add_Q16_errors = 0;
+  double multiply_Q16_error = 0, lerp_Q16_error = 0;
+  FOR_LONG(a, 8589931LL) {
+    FOR_LONG(b, 8388593LL) {
+      if ((long long)add_Q16(a, b) != (long long)clamp((double)a + b, -2147483648.0, 2147483647.0)) add_Q16_errors++;
+      double error = fabs(multiply_Q16(a, b) - clamp(a * (double)b / 65536.0, -2147483648.0, 2147483647.0));
+      if (error > multiply_Q16_error) multiply_Q16_error = error;
+      for (unsigned long t = 0; t <= 65535; t += 9362) {
+        error = fabs(lerp_Q16(a, b, t) - (a + (b - a) * (t / 65536.0)));
+        if (error > lerp_Q16_error) lerp_Q16_error = error;
+      }
+    }
+  }
+
+  // scale_by_percent: the whole int range, in steps, by every percentage
+  double percent_error = 0;
+  FOR_INT(value, 7) {
+    for (int pct = 0; pct <= 100; pct++) {
+      double error = fabs(scale_by_percent(value, pct) - value * pct / 100.0);
+      if (error > percent_error) percent_error = error;
+    }
+  }
+
+  // map_percent_to_range and map_byte_to_range: ranges across the whole int range
+  double range_error = 0, byte_range_error = 0;
+  FOR_INT(min, 1021) {
+    FOR_INT(max, 1019) {
+      for (int pct = 0; pct <= 100; pct++) {
+        double error = fabs(map_percent_to_range(pct, min, max) - (min + pct * (double)(max - min) / 100.0));
+        if (error > range_error) range_error = error;
+      }
+      for (int value = 0; value <= 255; value++) {
+        double error = fabs(map_byte_to_range(value, min, max) - (min + value * (double)(max - min) / 255.0));
+        if (error > byte_range_error) byte_range_error = error;
+      }
+    }
+  }
+
+  // map_percent_to_centred_range_Q16: every percentage, for ranges up to +/- 32767
+  double centred_error = 0;
+  for (long plus_or_minus = -32767; plus_or_minus <= 32767; plus_or_minus += 13) {
+    for (int pct = 0; pct <= 100; pct++) {
+      double exact = (pct - 50) * (double)plus_or_minus * 65536.0 / 50.0;
+      double error = fabs(map_percent_to_centred_range_Q16(pct, plus_or_minus) - exact);
+      if (error > centred_error) centred_error = error;
+    }
+  }
+
+  // map_percent_to_centred_exp_range_Q16: middles from 2^-8 to 2^8, up to +/- 8 octaves,
+  //  in cents where the result is big enough (>= 100000) and below saturation (2^32)
+  double centred_exp_error = 0;
+  for (int exp_mid = -8; exp_mid <= 8; exp_mid++) {
+    for (int plus_or_minus = 0; plus_or_minus <= 8; plus_or_minus++) {
+      for (int pct = 0; pct <= 100; pct++) {
+        double exact = 65536.0 * exp2(exp_mid + (pct - 50) * plus_or_minus / 50.0);
+        if (exact < 100000 || exact >= 4294967295.0) continue;
+        double error = cents(map_percent_to_centred_exp_range_Q16(pct, exp_mid, plus_or_minus) / exact);
+        if (error > centred_exp_error) centred_exp_error = error;
+      }
+    }
+  }
+
+  // map_mV_to_note_number: every mV value, against rounding mV / 83.3333 (halves away from zero, as round() does)
+  unsigned long note_number_errors = 0;
+  FOR_INT(mV, 1) {
+    if ((long)map_mV_to_note_number(mV) != (long)round(mV * 12 / 1000.0)) note_number_errors++;
+  }
+
+  // map_note_number_to_mV: every note from -393 to 393, against note * 83.3333 truncated towards zero
+  unsigned long note_mV_errors = 0;
+  for (long note = -393; note <= 393; note++) {
+    if ((long)map_note_number_to_mV(note) != (long)(note * 83.3333)) note_mV_errors++;
+  }
+
+  // map_mV_to_percent: every positive mV value, for a few maximums (with and without divide_by_byte)
+  unsigned long percent_errors = 0;
+  const int max_mVs[] = { 1000, 5000, 10000, 25500, 25600, 30000, 32767 };
+  for (int max_mV : max_mVs) {
+    for (long mV = 0; mV <= 32767; mV++) {
+      if ((long)map_mV_to_percent(mV, max_mV) != mV / (max_mV / 100)) percent_errors++;
+    }
+  }
+
+  unsigned long wrong = divide_errors + add_Q15_errors + add_Q16_errors + note_number_errors + note_mV_errors + percent_errors;
+
+  printf("%-36s %-36s %s\n", "helper", "sweep", "largest error");
+  printf("%-36s %-36s %.6f octaves (%.3f cents)\n", "log2_Q16", "1/65536 to 65536", log2_error, 1200.0 * log2_error);
+  printf("%-36s %-36s %.3f cents\n", "scale_by_exp2", "results 100000 to 16000000", exp2_error);
+  printf("%-36s %-36s %.3f%%\n", "power_Q16", "a 1/4 to 4, b -2 to 2", 100.0 * power_error);
+  printf("%-36s %-36s %lu wrong of %lu\n", "divide_by_byte", "0 to 65535, by 1 to 255", divide_errors, 65536UL * 255);
+  printf("%-36s %-36s %lu wrong\n", "add_Q15", "whole int range", add_Q15_errors);
+  printf("%-36s %-36s %.3f\n", "multiply_Q15", "whole int range", multiply_Q15_error);
+  printf("%-36s %-36s %.3f\n", "lerp_Q15", "whole int range, t 0 to 1", lerp_Q15_error);
+  printf("%-36s %-36s %lu wrong\n", "add_Q16", "whole long range", add_Q16_errors);
+  printf("%-36s %-36s %.3f\n", "multiply_Q16", "whole long range", multiply_Q16_error);
+  printf("%-36s %-36s %.3f\n", "lerp_Q16", "whole long range, t 0 to 1", lerp_Q16_error);
+  printf("%-36s %-36s %.3f\n", "scale_by_percent", "whole int range, 0 to 100%", percent_error);
+  printf("%-36s %-36s %.3f\n", "map_percent_to_range", "0 to 100%, whole int range", range_error);
+  printf("%-36s %-36s %.3f\n", "map_byte_to_range", "0 to 255, whole int range", byte_range_error);
+  printf("%-36s %-36s %.3f (in 1/65536)\n", "map_percent_to_centred_range_Q16", "0 to 100%, +/- 32767", centred_error);
+  printf("%-36s %-36s %.3f cents\n", "map_percent_to_centred_exp_range_Q16", "2^-8 to 2^8, +/- 8 octaves", centred_exp_error);
+  printf("%-36s %-36s %lu wrong\n", "map_mV_to_note_number", "-32768 to 32767 mV", note_number_errors);
+  printf("%-36s %-36s %lu wrong\n", "map_note_number_to_mV", "notes -393 to 393", note_mV_errors);
+  printf("%-36s %-36s %lu wrong\n", "map_mV_to_percent", "0 to 32767 mV, 7 maximums", percent_errors);
+  printf("\nsigned overflows with AVR int sizes: %lu\n", avr_overflows);
+  return wrong > 0 || avr_overflows > 0;
+}
+"""
+
+
+def literal_type(digits, suffix):
+    """Returns the AVR type of an integer literal, by the C++ rules for its base and suffix."""
+    value = int(digits, 0)
+    unsigned = "u" in suffix.lower()
+    is_long = "l" in suffix.lower()
+    decimal = not digits.lower().startswith("0x")
+    sizes = [(32767, "int16_t"), (65535, "uint16_t"), (2147483647, "int32_t"), (4294967295, "uint32_t"),
+             (9223372036854775807, "int64_t"), (18446744073709551615, "uint64_t")]
+    if is_long:
+        sizes = sizes[2:]
+    if unsigned:
+        sizes = [(limit, name) for limit, name in sizes if name.startswith("u")]
+    elif decimal:
+        sizes = [(limit, name) for limit, name in sizes if not name.startswith("u")]
+    for limit, name in sizes:
+        if value <= limit:
+            return name
+    raise ValueError("literal too big: " + digits + suffix)
+
+
+def to_avr_types(text):
+    """Swaps the integer types and literals of a helper file for the avr<> ones (flash tables are left as they are)."""
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    text = re.sub(r"//[^\n]*", "", text)
+    parts = re.split(r"(const uint\w+ \w+\[\d*\] PROGMEM = \{.*?\};)", text, flags=re.S)
+    for i in range(0, len(parts), 2):
+        part = parts[i]
+        part = re.sub(r"\b(u?int(8|16|32|64)_t)\b", r"avr_\1", part)
+        part = re.sub(r"\bunsigned long\b", "avr_ulong", part)
+        part = re.sub(r"\bunsigned int\b", "avr_uint", part)
+        part = re.sub(r"\blong\b", "avr_long", part)
+        part = re.sub(r"\bint\b", "avr_int", part)
+        part = re.sub(r"\bbyte\b", "avr_byte", part)
+        part = re.sub(r"(?<![\w.])(0[xX][0-9A-Fa-f]+|\d+)([uUlL]*)(?![\w.])",
+                      lambda m: "avr<%s>(%s)" % (literal_type(m.group(1), m.group(2)), m.group(1)), part)
+        parts[i] = part
+    return "".join(parts)
+
+
+def main():
+    compiler = sys.argv[1] if len(sys.argv) > 1 else "g++"
+    with tempfile.TemporaryDirectory() as folder:
+        stub = os.path.join(folder, "Arduino.h")
+        source = os.path.join(folder, "check.cpp")
+        program = os.path.join(folder, "check")
+        with open(stub, "w") as f:
+            f.write(ARDUINO_STUB)
+        for helper in HELPERS:
+            with open(os.path.join(BACKEND, helper)) as f:
+                text = f.read()
+            with open(os.path.join(folder, helper), "w") as f:
+                f.write(to_avr_types(text))
+        with open(source, "w") as f:
+            f.write(CHECKS)
+        subprocess.run([compiler, "-std=gnu++11", "-O2", "-include", stub, "-I", folder,
+                        "-o", program, source, "-lm"], check=True)
+        sys.exit(subprocess.run([program]).returncode)
+
+
+if __name__ == "__main__":
+    main()
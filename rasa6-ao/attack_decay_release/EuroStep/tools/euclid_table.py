@@ -0,0 +1,56 @@
+"""
+Script Name: euclid_table.py
+
+Purpose: Build the table of Euclidean rhythms used by the Euclid class.
+
+Dependencies: Python 3 (standard library only).
+
+Use: python euclid_table.py > table.txt
+-- then paste the table into 'add-ons/Euclid.h' (only needed if the algorithm changes)
+
+Each pattern comes from Bjorklund's algorithm, so it starts with an event and matches the
+published Euclidean rhythms (e.g., 3 in 8 is x..x..x.). Step i is bit i of a uint32_t, and
+the patterns are listed by steps (1 to 32), then by events (0 to steps).
+"""
+
+import sys
+
+MAX_STEPS = 32
+
+
+def bjorklund(events, steps):
+    """Return the pattern as a list of 0s and 1s."""
+    if events == 0:
+        return [0] * steps
+    front = [[1] for _ in range(events)]
+    back = [[0] for _ in range(steps - events)]
+    while len(back) > 1:
+        pairs = min(len(front), len(back))
+        remainder = front[pairs:] if len(front) > pairs else back[pairs:]
+        front = [front[i] + back[i] for i in range(pairs)]
+        back = remainder
+    return [bit for group in front + back for bit in group]
+
+
+def as_bits(pattern):
+    return sum(bit << i for i, bit in enumerate(pattern))
+
+
+def main():
+    out = sys.stdout
+    out.write("// generated by 'tools/euclid_table.py', so do not edit by hand\n")
+    out.write("const uint32_t euclid_patterns[] PROGMEM = {\n")
+    for steps in range(1, MAX_STEPS + 1):
+        patterns = [bjorklund(events, steps) for events in range(steps + 1)]
+        for events, pattern in enumerate(patterns):
+            if len(pattern) != steps or sum(pattern) != events:
+                raise ValueError("bad pattern for %d in %d" % (events, steps))
+        values = ["0x%08lXUL" % as_bits(pattern) for pattern in patterns]
+        for i in range(0, len(values), 8):
+            comment = "  // steps = %d" % steps if i == 0 else ""
+            out.write("  %s,%s\n" % (", ".join(values[i:i + 8]), comment))
+    out.write("};\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,85 @@
+"""
+Script Name: scl_to_header.py
+
+Purpose: Convert a Scala tuning file (.scl) into mV tables for the Quantiser class.
+
+Dependencies: Python 3 (standard library only).
+
+Use: python scl_to_header.py tuning.scl name > name.h
+-- tuning.scl: a Scala file, where each pitch is in cents (e.g., 701.955) or a ratio (e.g., 3/2)
+-- name: the name of the C++ array to create
+
+Then in the program:
+-- #include "name.h"
+-- load_tuning(name_mV, name_thresholds_mV, name_degrees): quantise to the tuning
+
+Both tables are saved in PROGMEM, so the Quantiser reads them from flash and keeps no copy in RAM:
+-- name_mV: each degree in mV above the root (1000 mV per 1200 cents), from 0 up to the period
+-- name_thresholds_mV: the mV halfway between each degree and the next, where the nearest degree changes
+
+Each degree is rounded to the nearest mV (1.2 cents).
+As in the Scala format, the last degree is the period (e.g., 1200 cents for an octave).
+"""
+
+import math
+import sys
+
+
+def parse_pitch(text):
+    """Return the pitch in cents, from either cents (has a '.') or a ratio."""
+    text = text.split()[0]
+    if "." in text:
+        return float(text)
+    if "/" in text:
+        numerator, denominator = text.split("/")
+        return 1200 * math.log2(int(numerator) / int(denominator))
+    return 1200 * math.log2(int(text))
+
+
+def read_scl(path):
+    """Return the description and the list of degrees in cents."""
+    with open(path, encoding="latin-1") as f:
+        lines = [line.strip() for line in f if not line.startswith("!")]
+    description = lines[0]
+    number_of_degrees = int(lines[1].split()[0])
+    pitches = [line for line in lines[2:] if line]
+    if len(pitches) < number_of_degrees:
+        raise ValueError("expected %d pitches but found %d" % (number_of_degrees, len(pitches)))
+    cents = [parse_pitch(pitch) for pitch in pitches[:number_of_degrees]]
+    if any(b <= a for a, b in zip([0.0] + cents, cents)):
+        raise ValueError("pitches must rise above 0 cents, with the period last")
+    return description, cents
+
+
+def write_table(name, values, out):
+    out.write("const int %s[] PROGMEM = {\n" % name)
+    for i in range(0, len(values), 12):
+        out.write("  %s,\n" % ", ".join("%d" % v for v in values[i:i + 12]))
+    out.write("};\n")
+
+
+def write_header(name, description, cents, source, out):
+    degree_mV = [0] + [int(math.floor(c * 1000 / 1200 + 0.5)) for c in cents]
+    thresholds_mV = [(low + high + 1) >> 1 for low, high in zip(degree_mV, degree_mV[1:])]
+    out.write("// Generated by scl_to_header.py from '%s'\n" % source)
+    if description:
+        out.write("// %s\n" % description)
+    out.write("// %d degrees, and the last is the period (%d mV)\n" % (len(cents), degree_mV[-1]))
+    out.write("const int %s_degrees = %d;\n" % (name, len(cents)))
+    out.write("// each degree in mV above the root, from 0 up to the period\n")
+    write_table(name + "_mV", degree_mV, out)
+    out.write("// the mV halfway between each degree and the next\n")
+    write_table(name + "_thresholds_mV", thresholds_mV, out)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write(__doc__)
+        sys.exit(1)
+    path, name = sys.argv[1], sys.argv[2]
+    description, cents = read_scl(path)
+    write_header(name, description, cents, path, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
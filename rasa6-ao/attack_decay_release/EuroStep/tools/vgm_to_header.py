@@ -0,0 +1,150 @@
+"""
+Script Name: vgm_to_header.py
+
+Purpose: Convert a VGM file (.vgm or .vgz) into a register stream for the VgmPlayer class.
+
+Dependencies: Python 3 (standard library only).
+
+Use: python vgm_to_header.py input.vgm name chip > name.h
+-- input.vgm: a VGM file, which may be gzipped (.vgz)
+-- name: the name of the C++ array to create
+-- chip: which chip to keep the writes for (sn76489, ym2612 or ym2149)
+
+Then in the program:
+-- #include "name.h"
+-- set_stream(name, name_length, name_loop): play the stream
+
+Only the writes for the chosen chip are kept (e.g., the YM2612 part of a Mega Drive song),
+along with all of the waits. Waits in a row are joined, and DAC samples (0x8n) are kept
+only as waits. The header is dropped, so the stream starts at the first command and
+ends with 0x66. The size of the stream is printed to stderr.
+"""
+
+import gzip
+import struct
+import sys
+
+CHIP_COMMANDS = {
+    "sn76489": (0x50,),
+    "ym2612": (0x52, 0x53),
+    "ym2149": (0xA0,),
+}
+
+# number of bytes after each command that is skipped (when not for the chosen chip)
+SKIP_LENGTHS = {0x4F: 1, 0x50: 1, 0x90: 4, 0x91: 4, 0x92: 5, 0x93: 10, 0x94: 1, 0x95: 4}
+
+
+def skip_length(command):
+    """Return how many bytes follow a command, from the VGM specification."""
+    if command in SKIP_LENGTHS:
+        return SKIP_LENGTHS[command]
+    if 0x30 <= command <= 0x3F:
+        return 1
+    if 0x40 <= command <= 0x5F or 0xA0 <= command <= 0xBF:
+        return 2
+    if 0xC0 <= command <= 0xDF:
+        return 3
+    if 0xE0 <= command <= 0xFF:
+        return 4
+    raise ValueError("unknown VGM command 0x%02X" % command)
+
+
+def read_vgm(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:2] == b"\x1f\x8b":
+        data = gzip.decompress(data)
+    if data[:4] != b"Vgm ":
+        raise ValueError("not a VGM file")
+    return data
+
+
+def convert(data, chip):
+    """Return the stream bytes and the loop position within the stream."""
+    version = struct.unpack_from("<I", data, 0x08)[0]
+    loop_offset = struct.unpack_from("<I", data, 0x1C)[0]
+    loop_offset = loop_offset + 0x1C if loop_offset else None
+    data_offset = 0x40
+    if version >= 0x150 and struct.unpack_from("<I", data, 0x34)[0]:
+        data_offset = struct.unpack_from("<I", data, 0x34)[0] + 0x34
+
+    keep = CHIP_COMMANDS[chip]
+    stream = bytearray()
+    loop_position = 0
+    pending_samples = 0
+
+    def flush_wait():
+        nonlocal pending_samples
+        while pending_samples > 0:
+            samples = min(pending_samples, 65535)
+            if samples <= 16:
+                stream.append(0x70 + samples - 1)
+            else:
+                stream.extend((0x61, samples & 0xFF, samples >> 8))
+            pending_samples -= samples
+
+    i = data_offset
+    while i < len(data):
+        if i == loop_offset:
+            flush_wait()
+            loop_position = len(stream)
+        command = data[i]
+        if command == 0x66:
+            break
+        elif command == 0x61:
+            pending_samples += struct.unpack_from("<H", data, i + 1)[0]
+            i += 3
+        elif command == 0x62:
+            pending_samples += 735
+            i += 1
+        elif command == 0x63:
+            pending_samples += 882
+            i += 1
+        elif 0x70 <= command <= 0x7F:
+            pending_samples += (command & 0x0F) + 1
+            i += 1
+        elif 0x80 <= command <= 0x8F:
+            pending_samples += command & 0x0F
+            i += 1
+        elif command == 0x67:
+            size = struct.unpack_from("<I", data, i + 3)[0] & 0x7FFFFFFF
+            i += 7 + size
+        elif command in keep and not (command == 0xA0 and data[i + 1] & 0x80):  # 0x80 is a second AY chip
+            length = skip_length(command)
+            flush_wait()
+            stream.append(command)
+            stream.extend(data[i + 1:i + 1 + length])
+            i += 1 + length
+        else:
+            i += 1 + skip_length(command)
+
+    flush_wait()
+    stream.append(0x66)
+    return stream, loop_position
+
+
+def write_header(name, stream, loop_position, chip, source, out):
+    out.write("// Generated by vgm_to_header.py from '%s' (%s writes only)\n" % (source, chip))
+    out.write("const unsigned int %s_length = %d;\n" % (name, len(stream)))
+    out.write("const unsigned int %s_loop = %d;\n" % (name, loop_position))
+    out.write("const byte %s[] PROGMEM = {\n" % name)
+    for i in range(0, len(stream), 16):
+        out.write("  %s,\n" % ", ".join("0x%02X" % b for b in stream[i:i + 16]))
+    out.write("};\n")
+
+
+def main():
+    if len(sys.argv) != 4 or sys.argv[3] not in CHIP_COMMANDS:
+        sys.stderr.write(__doc__)
+        sys.exit(1)
+    path, name, chip = sys.argv[1], sys.argv[2], sys.argv[3]
+    data = read_vgm(path)
+    stream, loop_position = convert(data, chip)
+    write_header(name, stream, loop_position, chip, path, sys.stdout)
+    sys.stderr.write("%d bytes (from %d), loop at %d\n" % (len(stream), len(data), loop_position))
+    if len(stream) > 32767:
+        sys.stderr.write("Note: over 32 KB, which will not fit in the flash of most boards\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,120 @@
+"""
+Script Name: wavetable_mipmaps.py
+
+Purpose: Build octave-spaced, band-limited copies of a wavetable for the Playback class.
+
+Dependencies: Python 3 (standard library only).
+
+Use: python wavetable_mipmaps.py source name [values_per_level] > name.h
+-- source: one of 'sine', 'triangle', 'saw', 'square', or a WAV file holding one cycle
+-- name: the name of the C++ array to create
+-- values_per_level: length of each table (default 256)
+
+Then in the program:
+-- #include "name.h"
+-- set_mipmapped_audio(name, name_length, name_levels): play the band-limited tables
+
+Level k keeps only the harmonics up to values_per_level / 2^(k+1), so it can be
+stepped through up to 2^k values at a time without aliasing. All levels share one
+scale factor, so switching levels does not change the volume.
+"""
+
+import cmath
+import math
+import sys
+import wave
+
+
+def make_shape(shape, length):
+    values = []
+    for i in range(length):
+        phase = i / length
+        if shape == "sine":
+            values.append(math.sin(2 * math.pi * phase))
+        elif shape == "triangle":
+            values.append(1 - 4 * abs(phase - 0.5))
+        elif shape == "saw":
+            values.append(2 * phase - 1)
+        elif shape == "square":
+            values.append(1.0 if phase < 0.5 else -1.0)
+        else:
+            raise ValueError("unknown shape '%s'" % shape)
+    return values
+
+
+def read_cycle(path, length):
+    """Read one cycle from the first channel of a WAV file, resampled to length."""
+    with wave.open(path, "rb") as f:
+        channels = f.getnchannels()
+        width = f.getsampwidth()
+        frames = f.readframes(f.getnframes())
+    raw = []
+    for i in range(0, len(frames), channels * width):
+        if width == 1:
+            raw.append((frames[i] - 128) / 128)
+        elif width == 2:
+            raw.append(int.from_bytes(frames[i:i + 2], "little", signed=True) / 32768)
+        else:
+            raise ValueError("only 8-bit and 16-bit WAV files are supported")
+    values = []
+    for i in range(length):
+        position = i * len(raw) / length
+        j = int(position)
+        fraction = position - j
+        values.append(raw[j] * (1 - fraction) + raw[(j + 1) % len(raw)] * fraction)
+    return values
+
+
+def spectrum_of(values):
+    """A plain DFT is fast enough for a single cycle."""
+    n = len(values)
+    return [sum(values[t] * cmath.exp(-2j * math.pi * k * t / n) for t in range(n)) for k in range(n)]
+
+
+def band_limit(spectrum, max_harmonic):
+    """Rebuild the cycle without any harmonic above max_harmonic."""
+    n = len(spectrum)
+    kept = [(k, spectrum[k]) for k in range(n) if min(k, n - k) <= max_harmonic]
+    return [sum(c * cmath.exp(2j * math.pi * k * t / n) for k, c in kept).real / n for t in range(n)]
+
+
+def make_levels(values):
+    spectrum = spectrum_of(values)
+    levels = []
+    max_harmonic = len(values) // 2  # level 0 keeps the table as it is
+    while max_harmonic >= 1:
+        levels.append(band_limit(spectrum, max_harmonic))
+        max_harmonic = max_harmonic // 2
+    return levels
+
+
+def write_header(name, levels, source, out):
+    peak = max(abs(v) for level in levels for v in level) or 1
+    out.write("// Generated by wavetable_mipmaps.py from '%s'\n" % source)
+    out.write("// %d band-limited levels of %d values, an octave apart\n" % (len(levels), len(levels[0])))
+    out.write("const int %s_length = %d;\n" % (name, len(levels[0])))
+    out.write("const int %s_levels = %d;\n" % (name, len(levels)))
+    out.write("const byte %s[] PROGMEM = {\n" % name)
+    for k, level in enumerate(levels):
+        out.write("  // level %d\n" % k)
+        codes = [max(0, min(255, int(round(128 + 127 * v / peak)))) for v in level]
+        for i in range(0, len(codes), 16):
+            out.write("  %s,\n" % ", ".join("%d" % c for c in codes[i:i + 16]))
+    out.write("};\n")
+
+
+def main():
+    if len(sys.argv) not in (3, 4):
+        sys.stderr.write(__doc__)
+        sys.exit(1)
+    source, name = sys.argv[1], sys.argv[2]
+    length = int(sys.argv[3]) if len(sys.argv) == 4 else 256
+    if source.lower().endswith(".wav"):
+        values = read_cycle(source, length)
+    else:
+        values = make_shape(source, length)
+    write_header(name, make_levels(values), source, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -2,7 +2,7 @@
 #include "EuroStep/EuroStep.h"
 #include "EuroStep/add-ons/Envelope.h"
 
-class make_envelope : public EuroStep::EuroStep {
+class make_envelope : public EuroStepT<make_envelope> {
 public:
 
   Envelope Env1;
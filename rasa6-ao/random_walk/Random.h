@@ -0,0 +1,82 @@
+/*
+Class Name: Random
+
+Purpose: Make fast random numbers that can be repeated from a seed (xorshift32).
+
+Dependencies: None.
+
+Use: Create an instance of the class and configure settings, then run:
+-- get_random(min, max): returns a number from min to max - 1 (like Arduino's random())
+-- get_chance(threshold): returns true with the chance set by the threshold
+-- -- note: make the threshold once from a percent with map_percent_to_threshold(percent)
+-- get_bits(): returns 32 random bits
+
+You may wish to configure the following settings:
+-- set_seed(value): use a fixed seed, so the same numbers come out every time (e.g., for tests)
+-- set_seed_from_noise(pin): seed from the noise on an analog pin and the time (default: a fixed seed)
+
+Each number is three shifts and three XORs, and ranges are made with a multiply and a
+shift instead of a division and modulo, so they cost far less than Arduino's random().
+The range (max - min) can be up to 65536, and each value is within (max - min) / 65536
+of a fair chance (e.g., 0.15% for 100 values).
+*/
+
+class Random {
+
+private:
+
+  uint32_t state = 2463534242UL;  // any value except 0
+
+public:
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Seed the generator
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void set_seed(uint32_t value) {
+    state = (value == 0) ? 2463534242UL : value;  // xorshift never leaves 0
+  }
+
+  // the lowest bit of each reading and the time it took are both noisy, so mix in both
+  void set_seed_from_noise(int pin) {
+    uint32_t value = state;
+    for (int i = 0; i < 32; i++) {
+      value = (value << 1 | value >> 31) ^ analogRead(pin) ^ micros();
+    }
+    set_seed(value);
+    get_bits();  // mix the seed before it is used
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Make random numbers
+  ///////////////////////////////////////////////////////////////////////////////
+
+  uint32_t get_bits() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+
+  // top 16 bits scaled to the range, so there is no division (range is at most 65536)
+  long get_random(long min, long max) {
+    if (max <= min) return min;
+    uint32_t range = max - min;
+    return min + (long)(((get_bits() >> 16) * range) >> 16);
+  }
+
+  long get_random(long max) {
+    return get_random(0, max);
+  }
+
+  // 0% is 0 (never) and 100% is 65536 (always), without a division
+  uint32_t map_percent_to_threshold(int percent) {
+    if (percent <= 0) return 0;
+    if (percent >= 100) return 65536UL;
+    return ((uint32_t)percent * 671089UL + 512) >> 10;  // 65536 / 100 in Q10
+  }
+
+  bool get_chance(uint32_t threshold) {
+    return (get_bits() >> 16) < threshold;
+  }
+};
@@ -0,0 +1,169 @@
+/*
+Class Name: RandomWalk
+
+Purpose: Make a smooth random voltage, which steps up or down at random and glides between steps.
+
+Dependencies: This class inherits from the Timer class and uses the Random class.
+
+Use: Create an instance of the class and configure settings, then run:
+-- run_walk(): update the current value (call this every step)
+-- get_current_value(): return the current value (in mV, e.g., to send to the DAC)
+
+You may wish to configure the following settings:
+-- set_step_size(mV): how far each step goes, up or down (default: 100)
+-- set_step_interval(ms): how long each step takes (default: 100)
+-- set_range(min_mV, max_mV): keep the walk inside a range (default: -1600 to 1600)
+-- use_cosine(): glide between steps along a cosine curve, which eases in and out (default)
+-- use_linear(): glide between steps in a straight line
+-- use_steps(): jump to each step at once
+-- set_seed(value) or set_seed_from_noise(pin): seed the random steps (see the Random class)
+
+The glide is worked out in fixed point every time run_walk() is called, so the value changes
+smoothly at the rate of the main loop, rather than once per step. The only division is done
+when the interval changes, and the cosine comes from a table in flash.
+*/
+
+// (1 - cos(pi * i / 64)) / 2 in Q15, so the curve rises from 0 to 32768
+const uint16_t random_walk_cosine_table[65] PROGMEM = {
+  0, 20, 79, 177, 315, 491, 705, 958, 1247, 1573, 1935, 2331, 2761,
+  3224, 3719, 4244, 4799, 5381, 5990, 6624, 7282, 7961, 8661, 9379, 10114, 10864,
+  11628, 12403, 13188, 13980, 14778, 15580, 16384, 17188, 17990, 18788, 19580, 20365, 21140,
+  21904, 22654, 23389, 24107, 24807, 25486, 26144, 26778, 27387, 27969, 28524, 29049, 29544,
+  30007, 30437, 30833, 31195, 31521, 31810, 32063, 32277, 32453, 32591, 32689, 32748, 32768
+};
+
+#define RANDOM_WALK_STEPS 0
+#define RANDOM_WALK_LINEAR 1
+#define RANDOM_WALK_COSINE 2
+
+class RandomWalk : public Timer {
+
+private:
+
+  Random Generator;
+
+  // the walk
+  int step_size = 100;
+  int min_value = -1600;
+  int max_value = 1600;
+  int from_value = 0;
+  int to_value = 0;
+  int current_value = 0;
+  byte interpolation = RANDOM_WALK_COSINE;
+
+  // time through the step in Q15, as (elapsed >> interval_shift) * reciprocal >> 15,
+  //  where the interval is shifted down to 15 bits, so nothing overflows 32 bits
+  unsigned long interval_micros = 100000;
+  byte interval_shift = 2;
+  unsigned long reciprocal = 0;
+
+  void update_reciprocal() {
+    interval_shift = 0;
+    while ((interval_micros >> interval_shift) >= 32768) interval_shift++;
+    reciprocal = (1UL << 30) / (interval_micros >> interval_shift);
+  }
+
+  void take_step() {
+    from_value = to_value;
+    long next_value = to_value;
+    if (Generator.get_random(2) == 1) {
+      next_value += step_size;
+    } else {
+      next_value -= step_size;
+    }
+    if (next_value < min_value) next_value = min_value;
+    if (next_value > max_value) next_value = max_value;
+    to_value = next_value;
+  }
+
+  unsigned int get_phase_Q15(unsigned long elapsed) {
+    if (elapsed >= interval_micros) return 32768;
+    return ((elapsed >> interval_shift) * reciprocal) >> 15;
+  }
+
+  unsigned int shape_by_cosine(unsigned int phase) {
+    if (phase >= 32768) return 32768;
+    int index = phase >> 9;  // 64 segments
+    unsigned int fraction = phase & 511;
+    unsigned int a = pgm_read_word(random_walk_cosine_table + index);
+    unsigned int b = pgm_read_word(random_walk_cosine_table + index + 1);
+    return a + (((unsigned long)(b - a) * fraction) >> 9);
+  }
+
+public:
+
+  RandomWalk() {
+    use_micros();
+    update_reciprocal();
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Getters and setters
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void set_step_size(int mV) {
+    step_size = abs(mV);
+  }
+
+  void set_step_interval(int ms) {
+    if (ms < 1) ms = 1;
+    unsigned long value = ms * 1000UL;
+    if (value == interval_micros) return;
+    interval_micros = value;
+    update_reciprocal();
+  }
+
+  void set_range(int min_mV, int max_mV) {
+    min_value = min_mV;
+    max_value = max_mV;
+  }
+
+  void use_steps() {
+    interpolation = RANDOM_WALK_STEPS;
+  }
+
+  void use_linear() {
+    interpolation = RANDOM_WALK_LINEAR;
+  }
+
+  void use_cosine() {
+    interpolation = RANDOM_WALK_COSINE;
+  }
+
+  void set_seed(uint32_t value) {
+    Generator.set_seed(value);
+  }
+
+  void set_seed_from_noise(int pin) {
+    Generator.set_seed_from_noise(pin);
+  }
+
+  int get_current_value() {
+    return current_value;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Run the walk
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void run_walk() {
+    unsigned long elapsed = get_timer();
+    if (elapsed >= interval_micros) {
+      take_step();
+      if (elapsed < 2 * interval_micros) {
+        advance_timer(interval_micros);  // keep steps evenly spaced despite loop jitter
+      } else {
+        reset_timer();  // too far behind to catch up, so start counting again
+      }
+      elapsed = get_timer();
+    }
+
+    unsigned int phase = get_phase_Q15(elapsed);
+    if (interpolation == RANDOM_WALK_STEPS) {
+      current_value = to_value;
+    } else {
+      if (interpolation == RANDOM_WALK_COSINE) phase = shape_by_cosine(phase);
+      current_value = from_value + (((long)(to_value - from_value) * phase) >> 15);
+    }
+  }
+};
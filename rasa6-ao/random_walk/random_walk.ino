@@ -1,6 +1,9 @@
 // for beetle, setup with Leonardo board
 #include "eurotools-v2.h"
-#include "mcp4822.h"
+#include "Mcp4822.h"
+#include "Timer.h"
+#include "Random.h"
+#include "RandomWalk.h"
 
 // set up pin config
 int PIN_CVIN = A2;
@@ -9,7 +12,7 @@ int PIN_POT2 = A1;
 int PIN_CS = 11;
 int PIN_SCK = 10;
 int PIN_SDI = 9;
-int PIN_LDAC = 0; // grounded in this module
+int PIN_LDAC = -1; // grounded in this module
 
 // set up hardware constants
 int R1_VALUE = 220;
@@ -25,15 +28,10 @@ int random_magnitude = 0;
 int random_interval = 0;
 
 // set up program logic
-int millis_new = 0;
-int millis_ref = 0;
-int millis_track = 0;
 int cv_offset = 0;
-bool dac_codeA[16];
-bool dac_codeB[16];
-int cv_outA_old = 0;
+RandomWalk walk;
+Mcp4822 dac;
 int cv_outA = 0;
-int cv_outB_old = 0;
 int cv_outB = 0;
 
 // toggle debug
@@ -49,6 +47,11 @@ void setup() {
   pinMode(PIN_CS, OUTPUT);
   pinMode(PIN_SCK, OUTPUT);
   pinMode(PIN_SDI, OUTPUT);
+  dac.set_pins(PIN_CS, PIN_SCK, PIN_SDI, PIN_LDAC);
+
+  // seed the random walk from the noise on the CV input
+  walk.set_seed_from_noise(PIN_CVIN);
+  walk.set_range(-1600, 1600);
 }
 
 void loop() {
@@ -82,39 +85,23 @@ void loop() {
   ///// RUN PROGRAM LOGIC
   //////////////////////////////////////////////////////////////////
 
-  // track time since last step in random walk
-  millis_new = millis();
-  millis_track = millis_new - millis_ref;
-
-  // every X seconds, take one step in the random walk
-  // there is a single 'offset' value that will increment or decrement
+  // every X ms, take one step in the random walk
+  // there is a single 'offset' value that will glide up or down
   //  according to the random magnitude pot value
-  if(millis_track > random_interval){
-    if(random(1, 10) > 5){
-      cv_offset = cv_offset + random_magnitude;
-    }else{
-      cv_offset = cv_offset - random_magnitude;
-    }
-    cv_offset = min(cv_offset, 1600);
-    cv_offset = max(cv_offset, -1600);
-    millis_ref = millis_new;
-  }
+  walk.set_step_size(random_magnitude);
+  walk.set_step_interval(random_interval);
+  walk.run_walk();
+  cv_offset = walk.get_current_value();
 
   // update CV out based on the offset
   // ChanA is input + offset
   // ChanB is input - offset
-  cv_outA_old = cv_outA;
   cv_outA = cv_in + cv_offset;
-  cv_outB_old = cv_outB;
   cv_outB = cv_in - cv_offset;
 
   if(debug){
     Serial.print ("CV offset: ");
     Serial.println (cv_offset);
-    Serial.print ("CV out A old: ");
-    Serial.println (cv_outA_old);
-    Serial.print ("CV out B old: ");
-    Serial.println (cv_outB_old);
     Serial.print ("CV out A: ");
     Serial.println (cv_outA);
     Serial.print ("CV out B: ");
@@ -125,15 +112,9 @@ void loop() {
   ///// WRITE OUTPUT
   //////////////////////////////////////////////////////////////////
 
-  if(cv_outA != cv_outA_old){
-    update_dac_code(dac_codeA, cv_outA, false, debug);
-    write_dac_code(dac_codeA, PIN_CS, PIN_SCK, PIN_SDI, PIN_LDAC);
-  }
-
-  if(cv_outB != cv_outB_old){
-    update_dac_code(dac_codeB, cv_outB, true, debug);
-    write_dac_code(dac_codeB, PIN_CS, PIN_SCK, PIN_SDI, PIN_LDAC);
-  }
+  // the DAC only writes a channel when its value changes
+  dac.send_to_channel_A(cv_outA);
+  dac.send_to_channel_B(cv_outB);
   
   if(debug) delay(250);
 }
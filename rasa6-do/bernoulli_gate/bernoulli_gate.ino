@@ -1,5 +1,6 @@
 // for beetle, setup with Leonardo board
 #include "eurotools-v2.h"
+#include "Random.h"
 
 // set up pin config
 int PIN_CLKIN = A2;
@@ -15,14 +16,15 @@ bool REVERSE_POT = true;
 
 // set up to read input
 bool current_clk = false;
-int pot1_pct = 0;
-int pot2_pct = 0;
+int pot1_pct = -1;
+int pot2_pct = -1;
 
 // set up program logic
 bool clk_reset = false;
-int randA = 0;
+Random rng;
+uint32_t thresholdA = 0;
 bool sendA = false;
-int randB = 0;
+uint32_t thresholdB = 0;
 bool sendB = false;
 
 // toggle debug
@@ -37,6 +39,9 @@ void setup() {
   pinMode(PIN_POT2, INPUT);
   pinMode(PIN_OUT1, OUTPUT);
   pinMode(PIN_OUT2, OUTPUT);
+
+  // seed from the noise on the clock input (use rng.set_seed(value) to repeat a run)
+  rng.set_seed_from_noise(PIN_CLKIN);
 }
 
 void loop() {
@@ -48,9 +53,17 @@ void loop() {
   // set incoming mV signal to TRUE if more than 500 mV
   current_clk = read_analog_bool(PIN_CLKIN, 500, R1_VALUE, R2_VALUE, debug);
 
-  // read pot voltages as percent
-  pot1_pct = read_analog_pct(PIN_POT1, 5000, REVERSE_POT, 0, 0, debug);
-  pot2_pct = read_analog_pct(PIN_POT2, 5000, REVERSE_POT, 0, 0, debug);
+  // read pot voltages as percent, and turn them into thresholds when they change
+  int new_pct = read_analog_pct(PIN_POT1, 5000, REVERSE_POT, 0, 0, debug);
+  if(new_pct != pot1_pct){
+    pot1_pct = new_pct;
+    thresholdA = rng.map_percent_to_threshold(pot1_pct);
+  }
+  new_pct = read_analog_pct(PIN_POT2, 5000, REVERSE_POT, 0, 0, debug);
+  if(new_pct != pot2_pct){
+    pot2_pct = new_pct;
+    thresholdB = rng.map_percent_to_threshold(pot2_pct);
+  }
 
   //////////////////////////////////////////////////////////////////
   ///// RUN PROGRAM LOGIC
@@ -62,27 +75,16 @@ void loop() {
 
     // run probability check
     // note: p(B) is conditional on p(A)
-    // send A/B if knob is bigger than runif
+    // send A/B if a random number is below the knob's threshold
     // if knob is 0, it never sends
     // if knob is 100, it always sends
-    randA = random(1, 100);
-    randB = random(1, 100);
-    sendA = false; // must reset every time!
-    sendB = false;
-    if(pot1_pct >= randA){
-      sendA = true;
-    }else{
-       if(pot2_pct >= randB){
-        sendB = true;
-      }
-    }
+    sendA = rng.get_chance(thresholdA);
+    sendB = !sendA && rng.get_chance(thresholdB);
 
     if(debug){
       Serial.print ("Status A: ");
-      Serial.println (randA);
       Serial.println (sendA);
       Serial.print ("Status B: ");
-      Serial.println (randB);
       Serial.println (sendB);
     }
     
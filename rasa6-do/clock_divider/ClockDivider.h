@@ -0,0 +1,92 @@
+/*
+Class Name: ClockDivider
+
+Purpose: Play one pulse for every few pulses of an incoming clock, including fractions (e.g., 3/2).
+
+Dependencies: None.
+
+Use: Create an instance of the class and configure settings, then run:
+-- clock_rise(): call when the incoming clock rises, returns whether an output pulse starts
+-- clock_fall(): call when the incoming clock falls
+-- get_output(): returns whether the output is high
+
+You may wish to configure the following settings:
+-- set_division(numerator, denominator): play 'denominator' pulses for every 'numerator'
+-- -- clock pulses (e.g., (4, 1) divides by 4 and (3, 2) divides by 1.5, default: (2, 1))
+-- -- note: the division is never less than 1, so the denominator is at most the numerator
+-- reset_division(): start an output pulse on the next clock rise
+
+The divider counts edges, so it follows a change of tempo from the very next pulse and
+never drifts from the clock. Fractions use an accumulator (as in Bresenham's line
+algorithm), so the output pulses always start on a clock rise and are spread as evenly as
+they can be. Each output pulse is high for about half of its length, starting on a clock rise
+and changing only on clock edges. There is no division, and the work is the same for every edge.
+*/
+
+class ClockDivider {
+
+private:
+
+  int numerator = 2;
+  int denominator = 1;
+  int accumulator = 0;  // a pulse starts when this reaches the numerator
+  bool started = false;
+
+  // high for the first half of each output pulse, which is numerator / denominator clock
+  //  pulses long, so count half clock pulses (times the denominator) since it started
+  //  and round down, so there is always a gap between pulses
+  int half_pulses = 0;
+  bool output = false;
+
+  void count_half_pulse() {
+    if (half_pulses < numerator) half_pulses += denominator;
+    output = half_pulses + denominator <= numerator;
+  }
+
+public:
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Getters and setters
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void set_division(int new_numerator, int new_denominator = 1) {
+    if (new_numerator < 1) new_numerator = 1;
+    if (new_denominator < 1) new_denominator = 1;
+    if (new_denominator > new_numerator) new_denominator = new_numerator;
+    numerator = new_numerator;
+    denominator = new_denominator;
+    if (accumulator >= numerator) accumulator = numerator - denominator;  // start a pulse on the next rise
+  }
+
+  void reset_division() {
+    started = false;
+  }
+
+  bool get_output() {
+    return output;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Run the divider
+  ///////////////////////////////////////////////////////////////////////////////
+
+  bool clock_rise() {
+    if (!started) {
+      started = true;
+      accumulator = numerator - denominator;
+    }
+    accumulator += denominator;
+    if (accumulator >= numerator) {
+      accumulator -= numerator;
+      half_pulses = 0;
+      output = true;
+      return true;
+    }
+    count_half_pulse();
+    return false;
+  }
+
+  void clock_fall() {
+    count_half_pulse();
+  }
+};
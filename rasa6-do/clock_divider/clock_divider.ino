@@ -1,5 +1,6 @@
 // for beetle, setup with Leonardo board
 #include "eurotools-v2.h"
+#include "ClockDivider.h"
 
 // set up pin config
 int PIN_CLKIN = A2;
@@ -19,21 +20,11 @@ int pot1_mV = 0;
 int pot2_mV = 0;
 int beats_per_cycle_1 = 1;
 int beats_per_cycle_2 = 1;
-int clk_ct = 0;
 
 // set up program logic
 bool clk_reset = false;
-int beat_counter = 0;
-int millis_per_cycle = 5000;
-int millis_residue = 0;
-int millis_track = 0;
-int millis_new = 0;
-int millis_old = 0;
-int millis_ref = 0;
-int subdiv_length_1 = 0;
-int subdiv_residue_1 = 0;
-int subdiv_length_2 = 0;
-int subdiv_residue_2 = 0;
+ClockDivider divider_1;
+ClockDivider divider_2;
 
 // toggle debug
 bool debug = false;
@@ -78,20 +69,17 @@ void loop() {
   ///// RUN PROGRAM LOGIC
   //////////////////////////////////////////////////////////////////
 
+  // play the number of beats in every 8 clock signals (e.g., 3 beats is a ratio of 8/3)
+  divider_1.set_division(8, beats_per_cycle_1);
+  divider_2.set_division(8, beats_per_cycle_2);
+
   // only run once per clock cycle
   // run on rising edge of incoming clock signal
-  millis_new = millis();
   if (current_clk & clk_reset) {
 
-    // advance the clock counter by 1
-    // if this is the 8th clock cycle, calculate time per cycle
-    // the *8 factor lets f multiplication work as f division
-    if (clk_ct == 8) {
-      millis_per_cycle = millis_new - millis_old;
-      millis_old = millis_new;
-      millis_ref = millis_new;
-      clk_ct = 0;
-    }
+    // count the clock signal
+    divider_1.clock_rise();
+    divider_2.clock_rise();
 
     if (debug) Serial.println("Advance clock.");
     clk_reset = false;
@@ -100,46 +88,18 @@ void loop() {
   // only run once per clock cycle
   // run on falling edge of incoming clock signal
   if (!current_clk & !clk_reset) {
+    divider_1.clock_fall();
+    divider_2.clock_fall();
     clk_reset = true;
-    clk_ct += 1;
-  }
-
-  millis_track = millis_new - millis_ref;                  // time since last clock signal
-  millis_residue = millis_track % millis_per_cycle;        // how far along in the clock signal
-  subdiv_length_1 = millis_per_cycle / beats_per_cycle_1;  // length of 1 sub-division (chan A)
-  subdiv_length_2 = millis_per_cycle / beats_per_cycle_2;  // length of 1 sub-division (chan B)
-  subdiv_residue_1 = millis_residue % subdiv_length_1;     // how far along in the sub-division (chan A)
-  subdiv_residue_2 = millis_residue % subdiv_length_2;     // how far along in the sub-division (chan B)
-  if (debug) {
-    Serial.print("Length of clock cycle (ms): ");
-    Serial.println(millis_per_cycle);
-    Serial.print("Time since last clock signal (ms): ");
-    Serial.println(millis_residue);
-    Serial.print("Sub-division length 1 value (ms): ");
-    Serial.println(subdiv_length_1);
-    Serial.print("Sub-division length 2 value (ms): ");
-    Serial.println(subdiv_length_2);
-    Serial.print("Sub-division residue 1 value (ms): ");
-    Serial.println(subdiv_residue_1);
-    Serial.print("Sub-division residue 2 value (ms): ");
-    Serial.println(subdiv_residue_2);
   }
 
   //////////////////////////////////////////////////////////////////
   ///// WRITE OUTPUT
   //////////////////////////////////////////////////////////////////
 
-  if (subdiv_residue_1 < (subdiv_length_1 / 2)) {
-    digitalWrite(PIN_OUT1, 1);  // PWM at 50%
-  } else {
-    digitalWrite(PIN_OUT1, 0);
-  }
-
-  if (subdiv_residue_2 < (subdiv_length_2 / 2)) {
-    digitalWrite(PIN_OUT2, 1);  // PWM at 50%
-  } else {
-    digitalWrite(PIN_OUT2, 0);
-  }
+  // each divided pulse is high for about 50% of its length
+  digitalWrite(PIN_OUT1, divider_1.get_output());
+  digitalWrite(PIN_OUT2, divider_2.get_output());
 
   if (debug) delay(250);
 }
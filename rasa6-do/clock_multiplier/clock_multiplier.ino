@@ -1,5 +1,6 @@
 // for beetle, setup with Leonardo board
 #include "eurotools-v2.h"
+#include "ClockMultiplier.h"
 
 // set up pin config
 int PIN_CLKIN = A2;
@@ -22,17 +23,8 @@ int beats_per_cycle_2 = 1;
 
 // set up program logic
 bool clk_reset = false;
-int beat_counter = 0;
-int millis_per_cycle = 5000;
-int millis_residue = 0;
-int millis_track = 0;
-int millis_new = 0;
-int millis_old = 0;
-int millis_ref = 0;
-int subdiv_length_1 = 0;
-int subdiv_residue_1 = 0;
-int subdiv_length_2 = 0;
-int subdiv_residue_2 = 0;
+ClockMultiplier multiplier_1;
+ClockMultiplier multiplier_2;
 
 // toggle debug
 bool debug = false;
@@ -77,18 +69,23 @@ void loop() {
   ///// RUN PROGRAM LOGIC
   //////////////////////////////////////////////////////////////////
 
+  // the new number of beats is used from the next clock signal
+  multiplier_1.set_multiplier(beats_per_cycle_1);
+  multiplier_2.set_multiplier(beats_per_cycle_2);
+
   // only run once per clock cycle
   // run on rising edge of incoming clock signal
-  millis_new = millis();
   if(current_clk & clk_reset){
 
-    // figure out how long it takes to complete one clock cycle
-    //  (from rising edge to rising edge)
-    millis_per_cycle = millis_new - millis_old;
-    millis_old = millis_new;
-    millis_ref = millis_new;
+    // time the clock signal, then restart the sub-divisions from it
+    multiplier_1.clock_rise();
+    multiplier_2.clock_rise();
 
-    if(debug) Serial.println ("Advance clock.");
+    if(debug){
+      Serial.println ("Advance clock.");
+      Serial.print ("Length of clock cycle (us): ");
+      Serial.println (multiplier_1.get_period());
+    }
     clk_reset = false;
   }
 
@@ -97,43 +94,14 @@ void loop() {
   if(!current_clk & !clk_reset){
     clk_reset = true;
   }
-  
-  millis_track = millis_new - millis_ref; // time since last clock signal
-  millis_residue = millis_track % millis_per_cycle; // how far along in the clock signal
-  subdiv_length_1 = millis_per_cycle / beats_per_cycle_1; // length of 1 sub-division (chan A) 
-  subdiv_length_2 = millis_per_cycle / beats_per_cycle_2; // length of 1 sub-division (chan B)
-  subdiv_residue_1 = millis_residue % subdiv_length_1; // how far along in the sub-division (chan A)
-  subdiv_residue_2 = millis_residue % subdiv_length_2; // how far along in the sub-division (chan B)
-  if(debug){
-    Serial.print ("Length of clock cycle (ms): ");
-    Serial.println (millis_per_cycle);
-    Serial.print ("Time since last clock signal (ms): ");
-    Serial.println (millis_residue);
-    Serial.print ("Sub-division length 1 value (ms): ");
-    Serial.println (subdiv_length_1);
-    Serial.print ("Sub-division length 2 value (ms): ");
-    Serial.println (subdiv_length_2);
-    Serial.print ("Sub-division residue 1 value (ms): ");
-    Serial.println (subdiv_residue_1);
-    Serial.print ("Sub-division residue 2 value (ms): ");
-    Serial.println (subdiv_residue_2);
-  }
 
   //////////////////////////////////////////////////////////////////
   ///// WRITE OUTPUT
   //////////////////////////////////////////////////////////////////
 
-  if(subdiv_residue_1 < (subdiv_length_1 / 2)){
-    digitalWrite(PIN_OUT1, 1); // PWM at 50%
-  }else{
-    digitalWrite(PIN_OUT1, 0);
-  }
-
-  if(subdiv_residue_2 < (subdiv_length_2 / 2)){
-    digitalWrite(PIN_OUT2, 1); // PWM at 50%
-  }else{
-    digitalWrite(PIN_OUT2, 0);
-  }
+  // each sub-division is high for 50% of its length
+  digitalWrite(PIN_OUT1, multiplier_1.run_multiplier());
+  digitalWrite(PIN_OUT2, multiplier_2.run_multiplier());
   
   if(debug) delay(250);
 }
@@ -1,6 +1,6 @@
 // for beetle, setup with Leonardo board
 #include "eurotools-v2.h"
-#include "update_euclid_rule.h"
+#include "Euclid.h"
 
 // set up pin config
 int PIN_CLKIN = A2;
@@ -23,10 +23,9 @@ int beats_per_cycle = 0;
 
 // set up program logic
 bool clk_reset = false;
-int beat_counter = 0;
 int event_swap = 0;
-int euclid_rule1[32];
 int offset = 0;
+Euclid rhythm;
 
 // toggle debug
 bool debug = false;
@@ -86,11 +85,21 @@ void loop() {
   // run on rising edge of incoming clock signal
   if(current_clk & clk_reset){
 
+    // update the Euclid rule (only reloaded when the pots have changed)
+    rhythm.set_pattern(events_per_cycle, beats_per_cycle);
+    rhythm.set_rotation(offset);
+
     // update the beat counter
-    beat_counter = beat_counter + 1;
-    beat_counter = beat_counter % beats_per_cycle;
+    rhythm.next_step();
 
-    if(debug) Serial.println ("Advance clock.");
+    if(debug){
+      Serial.print("Euclid rule: ");
+      for(int z = 0; z < beats_per_cycle; z = z + 1){
+        Serial.print (bitRead(rhythm.get_pattern(), z));
+      }
+      Serial.println ("");
+      Serial.println ("Advance clock.");
+    }
     clk_reset = false;
   }
 
@@ -100,18 +109,6 @@ void loop() {
     clk_reset = true;
   }
 
-  // update Euclid rule at start of cycle
-  if(beat_counter == 0){
-    update_euclid_rule(euclid_rule1, events_per_cycle, beats_per_cycle, offset);
-    if(debug){
-      Serial.print("Euclid rule: ");
-      for(int z = 0; z < beats_per_cycle; z = z + 1){
-        Serial.print (euclid_rule1[z]);
-      }
-      Serial.println ("");
-    }
-  }
-
   //////////////////////////////////////////////////////////////////
   ///// WRITE OUTPUT
   //////////////////////////////////////////////////////////////////
@@ -120,8 +117,8 @@ void loop() {
   // when clock rises HIGH, write output based on Euclid Rule
   // when clock falls LOW, disable output
   if(current_clk){
-    digitalWrite(PIN_OUT1, euclid_rule1[beat_counter]); // outputs Euclid Rule
-    digitalWrite(PIN_OUT2, !euclid_rule1[beat_counter]); // outputs NOT(Euclid Rule)
+    digitalWrite(PIN_OUT1, rhythm.is_event()); // outputs Euclid Rule
+    digitalWrite(PIN_OUT2, !rhythm.is_event()); // outputs NOT(Euclid Rule)
   }else{
     digitalWrite(PIN_OUT1, 0);
     digitalWrite(PIN_OUT2, 0);
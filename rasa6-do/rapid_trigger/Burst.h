@@ -0,0 +1,246 @@
+/*
+Class Name: Burst
+
+Purpose: Play a burst of evenly spaced pulses on a pin, timed by a hardware timer.
+
+Dependencies: Timer1 (on the ATmega32U4 and ATmega328P), which is set to count in 4 us steps.
+-- note: this stops analogWrite() on the pins that use Timer1 (e.g., 9 and 10 on a Leonardo)
+
+Use: Create an instance of the class and configure settings, then run:
+-- begin(pin, channel): the output pin, and which compare channel of Timer1 to use (0 or 1)
+-- -- note: use channel 0 for one output and channel 1 for a second output
+-- trigger(count, period_micros, width_micros): play 'count' pulses, each 'width_micros'
+-- -- high and then low for the rest of 'period_micros'
+-- -- note: triggering again mid-burst starts the new burst from now
+-- is_running(): returns whether the burst (including the last low part) is still playing
+-- stop(): end the burst now and set the pin low
+
+The timer interrupt writes each edge at its exact time, so the loop does nothing while the
+burst plays. Each high or low part can be from 16 us up to 131 ms (at 16 MHz). If the
+interrupt is held up past an edge (e.g., by other interrupts), the edge is played just late
+instead of being lost. On other boards, call run_burst() as often as possible instead, which
+plays the same burst from micros().
+
+Note: this file defines the Timer1 compare interrupts (and burst_channels), so include it
+from one file of the sketch only, or the interrupt vectors are defined twice.
+*/
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#define BURST_MICROS_PER_TICK (64000000UL / F_CPU)  // Timer1 counts F_CPU / 64 per second
+#define BURST_MIN_TICKS 4  // leaves time for the interrupt to set the next edge before it is due
+#define BURST_MAX_TICKS 32767
+
+#if defined(__AVR__) && defined(TIMSK1) && defined(OCR1B)
+#define BURST_USES_TIMER1
+#endif
+
+class Burst;
+Burst* burst_channels[2] = { nullptr, nullptr };
+
+class Burst {
+
+private:
+
+  int channel = 0;
+  int pin = -1;
+
+  // the output pin, written directly so the interrupt is short
+#ifdef BURST_USES_TIMER1
+  volatile uint8_t* pin_register = nullptr;
+  uint8_t pin_mask = 0;
+#endif
+
+  // the burst, where each edge is one event (the last event ends the final low part)
+  volatile int events_left = 0;
+  volatile bool running = false;
+  bool output_high = false;
+  uint16_t high_ticks = BURST_MIN_TICKS;
+  uint16_t low_ticks = BURST_MIN_TICKS;
+  uint16_t next_tick = 0;
+
+  static uint16_t micros_to_ticks(unsigned long value) {
+    unsigned long ticks = value / BURST_MICROS_PER_TICK;
+    if (ticks < BURST_MIN_TICKS) ticks = BURST_MIN_TICKS;
+    if (ticks > BURST_MAX_TICKS) ticks = BURST_MAX_TICKS;
+    return ticks;
+  }
+
+  static uint16_t now_ticks() {
+#ifdef BURST_USES_TIMER1
+    return TCNT1;
+#else
+    return micros() / BURST_MICROS_PER_TICK;
+#endif
+  }
+
+  void write_pin(bool value) {
+    output_high = value;
+#ifdef BURST_USES_TIMER1
+    if (value) {
+      *pin_register |= pin_mask;
+    } else {
+      *pin_register &= ~pin_mask;
+    }
+#else
+    digitalWrite(pin, value);
+#endif
+  }
+
+  void set_compare() {
+#ifdef BURST_USES_TIMER1
+    TIFR1 = (channel == 0) ? _BV(OCF1A) : _BV(OCF1B);  // clear a match of the last edge first
+    if (channel == 0) {
+      OCR1A = next_tick;
+    } else {
+      OCR1B = next_tick;
+    }
+#endif
+  }
+
+  void schedule(uint16_t ticks) {
+    next_tick += ticks;
+    set_compare();
+#ifdef BURST_USES_TIMER1
+    // if the edge was already due when the compare was set, it would only match after the
+    //  timer wraps (262 ms later), so move it to just after now
+    while ((int16_t)(TCNT1 - next_tick) >= 0) {
+      next_tick = TCNT1 + BURST_MIN_TICKS;
+      set_compare();
+    }
+#endif
+  }
+
+  // the interrupt also changes the burst, so hold it off while the loop does (Timer1 only)
+  uint8_t pause_interrupts() {
+#ifdef BURST_USES_TIMER1
+    uint8_t old_SREG = SREG;
+    cli();
+    return old_SREG;
+#else
+    return 0;
+#endif
+  }
+
+  void resume_interrupts(uint8_t old_SREG) {
+#ifdef BURST_USES_TIMER1
+    SREG = old_SREG;
+#else
+    (void)old_SREG;
+#endif
+  }
+
+  void enable_interrupt(bool value) {
+#ifdef BURST_USES_TIMER1
+    uint8_t enable = (channel == 0) ? _BV(OCIE1A) : _BV(OCIE1B);
+    if (value) {
+      TIMSK1 |= enable;  // schedule() has already cleared any old match
+    } else {
+      TIMSK1 &= ~enable;
+    }
+#else
+    (void)value;
+#endif
+  }
+
+public:
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Set up the Burst
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void begin(int output_pin, int compare_channel = 0) {
+    channel = (compare_channel == 1) ? 1 : 0;
+    pin = output_pin;
+    pinMode(pin, OUTPUT);
+    burst_channels[channel] = this;
+#ifdef BURST_USES_TIMER1
+    pin_register = portOutputRegister(digitalPinToPort(pin));
+    pin_mask = digitalPinToBitMask(pin);
+    uint8_t old_SREG = SREG;
+    cli();
+    TCCR1A = 0;  // normal counting, with no PWM
+    TCCR1B = _BV(CS11) | _BV(CS10);  // F_CPU / 64
+    SREG = old_SREG;
+#endif
+    stop();
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+  /// Play the Burst
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void trigger(int count, unsigned long period_micros, unsigned long width_micros) {
+    if (pin == -1) return;
+    if (count < 1) {
+      stop();
+      return;
+    }
+    if (width_micros >= period_micros) width_micros = period_micros / 2;
+
+    // work out the ticks outside of the interrupt, then start the burst all at once
+    uint16_t new_high_ticks = micros_to_ticks(width_micros);
+    uint16_t new_low_ticks = micros_to_ticks(period_micros - width_micros);
+    uint8_t old_SREG = pause_interrupts();
+    high_ticks = new_high_ticks;
+    low_ticks = new_low_ticks;
+    write_pin(true);
+    events_left = 2 * count - 1;
+    running = true;
+    next_tick = now_ticks();
+    schedule(high_ticks);
+    enable_interrupt(true);
+    resume_interrupts(old_SREG);
+  }
+
+  void stop() {
+    uint8_t old_SREG = pause_interrupts();
+    enable_interrupt(false);
+    events_left = 0;
+    running = false;
+    if (pin != -1) write_pin(false);
+    resume_interrupts(old_SREG);
+  }
+
+  bool is_running() {
+    return running;
+  }
+
+  // called by the timer interrupt at each edge
+  void on_compare() {
+    if (events_left == 0) {
+      enable_interrupt(false);
+      running = false;
+      return;
+    }
+    events_left--;
+    if (output_high) {
+      write_pin(false);
+      schedule(low_ticks);
+    } else {
+      write_pin(true);
+      schedule(high_ticks);
+    }
+  }
+
+  // only needed on boards without Timer1
+  void run_burst() {
+#ifndef BURST_USES_TIMER1
+    while (running && (int16_t)(now_ticks() - next_tick) >= 0) on_compare();
+#endif
+  }
+};
+
+#ifdef BURST_USES_TIMER1
+
+ISR(TIMER1_COMPA_vect) {
+  if (burst_channels[0] != nullptr) burst_channels[0]->on_compare();
+}
+
+ISR(TIMER1_COMPB_vect) {
+  if (burst_channels[1] != nullptr) burst_channels[1]->on_compare();
+}
+
+#endif
@@ -1,6 +1,6 @@
 // for beetle, setup with Leonardo board
-#include "digitalWrite_at_fixed_interval.h"
 #include "eurotools-v2.h"
+#include "Burst.h"
 
 // set up pin config
 int PIN_CLKIN = A2;
@@ -23,8 +23,7 @@ int trigger_duration_ms = 0;
 
 // set up program logic
 bool clk_reset = false;
-bool cycle_finished = false;
-int triggers_available = 0;
+Burst burst;
 
 // toggle debug
 bool debug = false;
@@ -36,8 +35,8 @@ void setup() {
   pinMode(PIN_CLKIN, INPUT);
   pinMode(PIN_POT1, INPUT);
   pinMode(PIN_POT2, INPUT);
-  pinMode(PIN_OUT1, OUTPUT);
   pinMode(PIN_OUT2, OUTPUT);
+  burst.begin(PIN_OUT1, 0); // the timer plays the triggers on the first output
 }
 
 void loop() {
@@ -75,9 +74,10 @@ void loop() {
   // run on rising edge of incoming clock signal
   if (current_clk & clk_reset) {
 
-    // reset the rapid fire counter
+    // start (or restart) the rapid fire triggers
     // there are Y rapid fire triggers per event
-    triggers_available = number_of_triggers;
+    // each trigger is X ms HIGH followed by X ms LOW
+    burst.trigger(number_of_triggers, 2000UL * trigger_duration_ms, 1000UL * trigger_duration_ms);
 
     if (debug) Serial.println("Advance clock.");
     clk_reset = false;
@@ -93,28 +93,10 @@ void loop() {
   ///// WRITE OUTPUT
   //////////////////////////////////////////////////////////////////
 
-  // when triggered by clock rise:
-  // - write and decrement triggers until none are available in pool
-  // - each trigger writes X/2 ms HIGH followed by X/2 ms LOW
-  // - cycle_finished = true after X ms has passed
-  if (triggers_available > -1) {  // one trigger is spent to set up the cycle_finished switch
-
-    digitalWrite(PIN_OUT2, 1);  // the second output sends TRUE while rapid fire trigger occurs
-    cycle_finished = digitalWrite_at_fixed_interval(PIN_OUT1, trigger_duration_ms);
-    if (cycle_finished) {
-      triggers_available = triggers_available - 1;
-      if (debug) {
-        Serial.print("Triggers available: ");
-        Serial.println(triggers_available);
-      }
-    }
-
-  } else {
-
-    // disable all output
-    digitalWrite(PIN_OUT1, 0);
-    digitalWrite(PIN_OUT2, 0);
-  }
+  // the first output is written by the timer (run_burst() only does anything on boards without one)
+  // the second output sends TRUE while rapid fire trigger occurs
+  burst.run_burst();
+  digitalWrite(PIN_OUT2, burst.is_running());
 
   if (debug) delay(250);
 }